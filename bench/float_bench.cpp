@@ -0,0 +1,112 @@
+// FloatFormat vs the conversions it replaced: fixed and shortest
+// formatting on the to_chars kernels against std::to_string and a
+// setprecision(6) stream, and ParseFloat (from_chars) against std::stod.
+//
+// usage: float_bench [conversions]   (default 10^7)
+#include "FloatFormat.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Inputs are cycled from a pool spread over many magnitudes
+constexpr size_t kPool = size_t(1) << 16;
+
+template <class F>
+double Millis(F &&body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char *what, double ms, size_t check) {
+  std::printf("%-28s %9.1f ms   (%zu)\n", what, ms, check);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  std::mt19937_64 rng(2048);
+  std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+  std::uniform_int_distribution<int> exponent(-8, 12);
+  std::vector<double> values(kPool);
+  std::vector<std::string> texts(kPool);
+  for (size_t i = 0; i < kPool; i++) {
+    values[i] = mantissa(rng) * std::pow(10.0, exponent(rng));
+    texts[i] = FormatShortest(values[i]);
+  }
+
+  size_t check = 0;
+  double ms = Millis([&] {
+    for (size_t i = 0; i < n; i++) {
+      check += std::to_string(values[i % kPool]).size();
+    }
+  });
+  Report("fixed  std::to_string", ms, check);
+
+  check = 0;
+  ms = Millis([&] {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(6);
+    for (size_t i = 0; i < n; i++) {
+      out.str("");
+      out << values[i % kPool];
+      check += out.str().size();
+    }
+  });
+  Report("fixed  setprecision(6)", ms, check);
+
+  check = 0;
+  ms = Millis([&] {
+    char buf[kFloatBufSize];
+    for (size_t i = 0; i < n; i++) {
+      check += FormatFixed(values[i % kPool], buf);
+    }
+  });
+  Report("fixed  FormatFixed", ms, check);
+
+  check = 0;
+  ms = Millis([&] {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    for (size_t i = 0; i < n; i++) {
+      out.str("");
+      out << values[i % kPool];
+      check += out.str().size();
+    }
+  });
+  Report("repr   setprecision(17)", ms, check);
+
+  check = 0;
+  ms = Millis([&] {
+    for (size_t i = 0; i < n; i++) {
+      check += FormatShortest(values[i % kPool]).size();
+    }
+  });
+  Report("repr   FormatShortest", ms, check);
+
+  double sum = 0;
+  ms = Millis([&] {
+    for (size_t i = 0; i < n; i++) {
+      sum += std::stod(texts[i % kPool]);
+    }
+  });
+  Report("parse  std::stod", ms, static_cast<size_t>(std::fabs(sum)));
+
+  sum = 0;
+  ms = Millis([&] {
+    for (size_t i = 0; i < n; i++) {
+      sum += ParseFloat(texts[i % kPool]);
+    }
+  });
+  Report("parse  ParseFloat", ms, static_cast<size_t>(std::fabs(sum)));
+  return 0;
+}
@@ -0,0 +1,162 @@
+// Value vs std::any: the same int, float and string loops on the tagged
+// Value and on the std::any representation it replaced, whose operators
+// are reproduced below with the old dispatch (typeid tests, int2048 for
+// every int, a std::string copy per concatenation).
+//
+// usage: value_bench [iterations]   (default 10^7)
+#include "int2048.h"
+#include "operator.h"
+#include "Value.h"
+#include <any>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+sjtu::int2048 AnyInt(const std::any &a) {
+  if (a.type() == typeid(sjtu::int2048)) {
+    return std::any_cast<sjtu::int2048>(a);
+  } else if (a.type() == typeid(bool)) {
+    return sjtu::int2048(std::any_cast<bool>(a) ? 1 : 0);
+  } else if (a.type() == typeid(double)) {
+    return sjtu::int2048((long long)(std::any_cast<double>(a)));
+  }
+  return sjtu::int2048(0);
+}
+
+double AnyFloat(const std::any &a) {
+  if (a.type() == typeid(bool)) {
+    return std::any_cast<bool>(a) ? 1.0 : 0.0;
+  } else if (a.type() == typeid(sjtu::int2048)) {
+    return double(std::any_cast<sjtu::int2048>(a));
+  } else if (a.type() == typeid(double)) {
+    return std::any_cast<double>(a);
+  }
+  return 0.0;
+}
+
+std::string AnyString(const std::any &a) {
+  if (a.type() == typeid(std::string)) {
+    return std::any_cast<std::string>(a);
+  } else if (a.type() == typeid(sjtu::int2048)) {
+    return std::string(std::any_cast<sjtu::int2048>(a));
+  } else if (a.type() == typeid(double)) {
+    return std::to_string(std::any_cast<double>(a));
+  }
+  return "";
+}
+
+std::any AnyAdd(const std::any &a, const std::any &b) {
+  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
+    return AnyString(a) + AnyString(b);
+  }
+  if (a.type() == typeid(double) || b.type() == typeid(double)) {
+    return AnyFloat(a) + AnyFloat(b);
+  }
+  return AnyInt(a) + AnyInt(b);
+}
+
+std::any AnySub(const std::any &a, const std::any &b) {
+  if (a.type() == typeid(double) || b.type() == typeid(double)) {
+    return AnyFloat(a) - AnyFloat(b);
+  }
+  return AnyInt(a) - AnyInt(b);
+}
+
+std::any AnyMul(const std::any &a, const std::any &b) {
+  if (a.type() == typeid(double) || b.type() == typeid(double)) {
+    return AnyFloat(a) * AnyFloat(b);
+  }
+  return AnyInt(a) * AnyInt(b);
+}
+
+bool AnyLess(const std::any &a, const std::any &b) {
+  if (a.type() == typeid(double) || b.type() == typeid(double)) {
+    return AnyFloat(a) < AnyFloat(b);
+  }
+  return AnyInt(a) < AnyInt(b);
+}
+
+// Strings are reset to empty every this many appends, so both sides stay
+// linear and only the per-operation cost is compared
+constexpr long kStrReset = 64;
+
+template <class F>
+double Millis(F &&body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Report(const char *loop, double any, double value, const std::string &check) {
+  std::printf("%-6s std::any %9.1f ms   Value %9.1f ms   x%.1f   (%s)\n", loop, any, value, any / value,
+              check.c_str());
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  long n = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+  // acc = acc + i * 3 - i while i < n
+  std::any aacc = sjtu::int2048(0), ai = sjtu::int2048(0);
+  const std::any athree = sjtu::int2048(3), aone = sjtu::int2048(1), an = sjtu::int2048(n);
+  double any = Millis([&] {
+    for (; AnyLess(ai, an); ai = AnyAdd(ai, aone)) {
+      aacc = AnySub(AnyAdd(aacc, AnyMul(ai, athree)), ai);
+    }
+  });
+  Value vacc(0), vi(0);
+  const Value vthree(3), vone(1), vn(static_cast<long long>(n));
+  double value = Millis([&] {
+    for (; vi < vn; vi = vi + vone) {
+      vacc = vacc + vi * vthree - vi;
+    }
+  });
+  Report("int", any, value, AnyString(aacc) + " = " + GetString(vacc));
+
+  // f = f * 0.5 + x, with x the loop counter as a float
+  std::any af = 0.0, ax = 0.0;
+  const std::any ahalf = 0.5, afone = 1.0, afn = static_cast<double>(n);
+  any = Millis([&] {
+    for (; AnyLess(ax, afn); ax = AnyAdd(ax, afone)) {
+      af = AnyAdd(AnyMul(af, ahalf), ax);
+    }
+  });
+  Value vf(0.0), vx(0.0);
+  const Value vhalf(0.5), vfone(1.0), vfn(static_cast<double>(n));
+  value = Millis([&] {
+    for (; vx < vfn; vx = vx + vfone) {
+      vf = vf * vhalf + vx;
+    }
+  });
+  Report("float", any, value, AnyString(af) + " = " + GetString(vf));
+
+  // s = s + "ab", restarted every kStrReset appends
+  std::any as = std::string(), apiece = std::string("ab");
+  size_t alen = 0;
+  any = Millis([&] {
+    for (long i = 0; i < n; i++) {
+      if (i % kStrReset == 0) {
+        alen += std::any_cast<std::string &>(as).size();
+        as = std::string();
+      }
+      as = AnyAdd(as, apiece);
+    }
+  });
+  Value vs(""), vpiece("ab");
+  size_t vlen = 0;
+  value = Millis([&] {
+    for (long i = 0; i < n; i++) {
+      if (i % kStrReset == 0) {
+        vlen += GetString(vs).size();
+        vs = Value("");
+      }
+      vs = vs + vpiece;
+    }
+  });
+  Report("str", any, value, std::to_string(alen) + " = " + std::to_string(vlen));
+  return 0;
+}
@@ -0,0 +1,18 @@
+#include "Ast.h"
+#include <algorithm>
+#include <cstdint>
+
+void *Arena::Allocate(size_t size, size_t align) {
+  auto addr = reinterpret_cast<uintptr_t>(cur_);
+  auto aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+  if (cur_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+    size_t block = std::max(kBlockSize, size + align);
+    blocks_.emplace_back(new char[block]);
+    cur_ = blocks_.back().get();
+    end_ = cur_ + block;
+    addr = reinterpret_cast<uintptr_t>(cur_);
+    aligned = (addr + align - 1) & ~(uintptr_t(align) - 1);
+  }
+  cur_ = reinterpret_cast<char *>(aligned + size);
+  return reinterpret_cast<void *>(aligned);
+}
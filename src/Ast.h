@@ -0,0 +1,117 @@
+#pragma once
+#ifndef AST_H
+#define AST_H
+
+#include "operator.h"
+#include "Value.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for the lowered tree. Everything placed here is trivially
+// destructible, so the whole arena is released block by block at once.
+class Arena {
+private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+  std::vector<std::unique_ptr<char[]>> blocks_{};
+  char *cur_ = nullptr;
+  char *end_ = nullptr;
+
+  void *Allocate(size_t size, size_t align);
+
+public:
+  template <class T>
+  T *NewArray(size_t n) {
+    static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+    return static_cast<T *>(Allocate(sizeof(T) * n, alignof(T)));
+  }
+};
+
+enum NODEKIND {
+  // Expressions
+  kCONST,     // index_: constant
+  kNAME,      // index_: name
+  kNEG,       // -child_[0]
+  kBINARY,    // child_[0] op_ child_[1]
+  kCOMPARE,   // child_[0] ops_[0] child_[1] ops_[1] ... as one chain
+  kAND,       // short-circuit over child_, yields a bool
+  kOR,        // short-circuit over child_, yields a bool
+  kNOT,       // not child_[0]
+  kCALL,      // index_: callee name; child_: positional args then kKEYWORD
+  kKEYWORD,   // index_: parameter name; child_[0]: argument
+  kFSTRING,   // child_: text constants and fields, joined as strings
+  kLIST,      // comma-separated expressions
+  // Quickened forms the tree engine rewrites kBINARY and two-operand
+  // kCOMPARE nodes into, once their operands were seen to be
+  kBINARYINT,    // small ints
+  kBINARYFLOAT,  // floats
+  kCOMPAREINT,   // small ints
+  kCOMPAREFLOAT, // floats
+  // Statements
+  kBLOCK,     // child_: statements in order
+  kEXPR,      // child_: expressions evaluated for effect
+  kASSIGN,    // child_[0]: kLIST of values; child_[1..]: kLIST of target names,
+              // rightmost target first
+  kAUGASSIGN, // index_: name; op_; child_[0]: value
+  kIF,        // child_: test, block pairs, then an optional else block
+  kWHILE,     // child_[0]: test; child_[1]: block
+  kBREAKSTMT,
+  kCONTINUESTMT,
+  kRETURNSTMT, // child_: returned values (none, one, or a tuple)
+  kDEF        // index_: function; child_: default argument expressions
+};
+
+// Slot of a name that is not a local of the enclosing function
+constexpr uint32_t kNOSLOT = UINT32_MAX;
+
+struct Node {
+  NODEKIND kind_;
+  OPKIND op_;
+  uint32_t index_;
+  uint32_t size_;
+  Node **child_;
+  const OPKIND *ops_;
+  // kNAME, kAUGASSIGN: frame slot of index_ in the enclosing function;
+  // kCALL: call site number
+  uint32_t slot_ = kNOSLOT;
+  // Quickened kinds: how often the type guard failed and the node went
+  // back to its generic kind
+  uint16_t deopts_ = 0;
+};
+
+// The kind a quickened node was rewritten from, or the kind itself
+inline NODEKIND GenericKind(NODEKIND kind) {
+  if (kind == kBINARYINT || kind == kBINARYFLOAT) {
+    return kBINARY;
+  } else if (kind == kCOMPAREINT || kind == kCOMPAREFLOAT) {
+    return kCOMPARE;
+  }
+  return kind;
+}
+
+struct FuncInfo {
+  uint32_t name_;
+  // Parameter names; the last child_size of the kDEF node have defaults
+  std::vector<uint32_t> params_;
+  Node *body_;
+  // Name of each frame slot: the parameters, then every other name the
+  // body mentions
+  std::vector<uint32_t> locals_{};
+};
+
+// A lowered module: the statement tree plus the tables its indices point to.
+// Holds no reference to the ANTLR parse tree it came from.
+struct Program {
+  Arena arena_;
+  std::vector<Value> consts_;
+  std::vector<std::string> names_;
+  std::vector<FuncInfo> funcs_;
+  Node *body_ = nullptr;
+  // Callee name of each call site, by site number
+  std::vector<uint32_t> calls_{};
+};
+
+#endif // AST_H
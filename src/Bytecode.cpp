@@ -0,0 +1,292 @@
+#include "Bytecode.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+class Compiler {
+private:
+  const Program &program_;
+  Module &module_;
+  Code *code_ = nullptr;
+  // First free register; expressions release their temporaries on exit
+  uint32_t next_ = 0;
+  struct Loop {
+    uint32_t start_;
+    std::vector<size_t> breaks_;
+  };
+  std::vector<Loop> loops_{};
+  uint32_t none_ = 0, true_ = 0, false_ = 0;
+
+  uint32_t Temp() {
+    code_->nregs_ = std::max(code_->nregs_, next_ + 1);
+    return next_++;
+  }
+  size_t Emit(OPCODE op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, OPKIND kind = kADD) {
+    code_->instrs_.push_back(Instr{op, kind, a, b, c});
+    return code_->instrs_.size() - 1;
+  }
+  uint32_t Here() const {
+    return code_->instrs_.size();
+  }
+  // Point the jump emitted at `at` to `target`
+  void Patch(size_t at, uint32_t target) {
+    auto &instr = code_->instrs_[at];
+    (instr.op_ == kOPJUMP ? instr.a_ : instr.b_) = target;
+  }
+
+  void Expr(const Node *, uint32_t dst);
+  void Stmt(const Node *);
+
+public:
+  Compiler(const Program &program, Module &module) : program_(program), module_(module) {}
+  void Run();
+};
+
+void Compiler::Run() {
+  module_.consts_ = program_.consts_;
+  module_.consts_.push_back(Value());
+  none_ = module_.consts_.size() - 1;
+  module_.consts_.push_back(Value(true));
+  true_ = module_.consts_.size() - 1;
+  module_.consts_.push_back(Value(false));
+  false_ = module_.consts_.size() - 1;
+
+  module_.codes_.resize(program_.funcs_.size() + 1);
+  for (size_t i = 0; i <= program_.funcs_.size(); i++) {
+    code_ = &module_.codes_[i];
+    next_ = 0;
+    loops_.clear();
+    Stmt(i < program_.funcs_.size() ? program_.funcs_[i].body_ : program_.body_);
+    Emit(kOPRETURNNONE);
+  }
+}
+
+void Compiler::Expr(const Node *node, uint32_t dst) {
+  uint32_t save = next_;
+  switch (node->kind_) {
+    case kCONST:
+      Emit(kOPLOADK, dst, node->index_);
+      break;
+    case kNAME:
+      Emit(kOPLOADNAME, dst, node->index_, node->slot_);
+      break;
+    case kNEG:
+      Expr(node->child_[0], dst);
+      Emit(kOPNEG, dst, dst);
+      break;
+    case kNOT:
+      Expr(node->child_[0], dst);
+      Emit(kOPNOT, dst, dst);
+      break;
+    case kBINARY: {
+      Expr(node->child_[0], dst);
+      auto right = Temp();
+      Expr(node->child_[1], right);
+      Emit(kOPBINARY, dst, dst, right, node->op_);
+      break;
+    }
+    case kCOMPARE: {
+      // A false link leaves false in dst and skips the rest of the chain
+      auto left = Temp(), right = Temp();
+      std::vector<size_t> exits;
+      Expr(node->child_[0], left);
+      for (uint32_t i = 1; i < node->size_; i++) {
+        Expr(node->child_[i], right);
+        Emit(kOPCOMPARE, dst, left, right, node->ops_[i - 1]);
+        if (i + 1 < node->size_) {
+          exits.push_back(Emit(kOPJUMPIFNOT, dst));
+          Emit(kOPMOVE, left, right);
+        }
+      }
+      for (auto at : exits) {
+        Patch(at, Here());
+      }
+      break;
+    }
+    case kAND:
+    case kOR: {
+      // and stops at the first false operand, or at the first true one
+      bool is_and = node->kind_ == kAND;
+      std::vector<size_t> shortcuts;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i], dst);
+        shortcuts.push_back(Emit(is_and ? kOPJUMPIFNOT : kOPJUMPIF, dst));
+      }
+      Emit(kOPLOADK, dst, is_and ? true_ : false_);
+      auto done = Emit(kOPJUMP);
+      for (auto at : shortcuts) {
+        Patch(at, Here());
+      }
+      Emit(kOPLOADK, dst, is_and ? false_ : true_);
+      Patch(done, Here());
+      break;
+    }
+    case kCALL: {
+      // Positional arguments first, keyword values after them, each still
+      // evaluated in source order
+      CallSite site{node->index_, 0, {}};
+      for (uint32_t i = 0; i < node->size_; i++) {
+        if (node->child_[i]->kind_ != kKEYWORD) {
+          site.npos_++;
+        }
+      }
+      uint32_t base = next_;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Temp();
+      }
+      uint32_t pos = base, key = base + site.npos_;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        const Node *arg = node->child_[i];
+        if (arg->kind_ == kKEYWORD) {
+          site.keywords_.push_back(arg->index_);
+          Expr(arg->child_[0], key++);
+        } else {
+          Expr(arg, pos++);
+        }
+      }
+      module_.calls_.push_back(std::move(site));
+      Emit(kOPCALL, dst, module_.calls_.size() - 1, base);
+      break;
+    }
+    case kFSTRING: {
+      uint32_t base = next_;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i], Temp());
+      }
+      Emit(kOPFSTRING, dst, base, node->size_);
+      break;
+    }
+    default:
+      Emit(kOPLOADK, dst, none_);
+  }
+  next_ = save;
+}
+
+void Compiler::Stmt(const Node *node) {
+  uint32_t save = next_;
+  switch (node->kind_) {
+    case kBLOCK:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Stmt(node->child_[i]);
+      }
+      break;
+    case kEXPR: {
+      auto tmp = Temp();
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i], tmp);
+      }
+      break;
+    }
+    case kASSIGN: {
+      const Node *values = node->child_[0];
+      if (node->size_ == 2 && values->size_ == 1 && node->child_[1]->size_ == 1) {
+        // x = value
+        auto tmp = Temp();
+        Expr(values->child_[0], tmp);
+        const Node *target = node->child_[1]->child_[0];
+        Emit(kOPSTORENAME, target->index_, tmp, target->slot_);
+        break;
+      }
+      AssignSite site{values->size_, {}};
+      uint32_t base = next_;
+      for (uint32_t i = 0; i < values->size_; i++) {
+        Expr(values->child_[i], Temp());
+      }
+      for (uint32_t i = 1; i < node->size_; i++) {
+        std::vector<Target> row;
+        for (uint32_t j = 0; j < node->child_[i]->size_; j++) {
+          const Node *target = node->child_[i]->child_[j];
+          row.push_back(Target{target->index_, target->slot_});
+        }
+        site.rows_.push_back(std::move(row));
+      }
+      module_.assigns_.push_back(std::move(site));
+      Emit(kOPUNPACK, module_.assigns_.size() - 1, base);
+      break;
+    }
+    case kAUGASSIGN: {
+      auto tmp = Temp();
+      Expr(node->child_[0], tmp);
+      Emit(kOPAUGNAME, node->index_, tmp, node->slot_, node->op_);
+      break;
+    }
+    case kIF: {
+      std::vector<size_t> ends;
+      auto tmp = Temp();
+      for (uint32_t i = 0; i + 1 < node->size_; i += 2) {
+        Expr(node->child_[i], tmp);
+        auto skip = Emit(kOPJUMPIFNOT, tmp);
+        Stmt(node->child_[i + 1]);
+        ends.push_back(Emit(kOPJUMP));
+        Patch(skip, Here());
+      }
+      if (node->size_ % 2 == 1) {
+        Stmt(node->child_[node->size_ - 1]);
+      }
+      for (auto at : ends) {
+        Patch(at, Here());
+      }
+      break;
+    }
+    case kWHILE: {
+      auto tmp = Temp();
+      uint32_t start = Here();
+      Expr(node->child_[0], tmp);
+      auto exit = Emit(kOPJUMPIFNOT, tmp);
+      loops_.push_back(Loop{start, {}});
+      Stmt(node->child_[1]);
+      Emit(kOPJUMP, start);
+      Patch(exit, Here());
+      for (auto at : loops_.back().breaks_) {
+        Patch(at, Here());
+      }
+      loops_.pop_back();
+      break;
+    }
+    case kBREAKSTMT:
+    case kCONTINUESTMT:
+      if (loops_.empty()) {
+        // Outside a loop the flow ends the function, as in the tree walker
+        Emit(kOPRETURNNONE);
+      } else if (node->kind_ == kBREAKSTMT) {
+        loops_.back().breaks_.push_back(Emit(kOPJUMP));
+      } else {
+        Emit(kOPJUMP, loops_.back().start_);
+      }
+      break;
+    case kRETURNSTMT: {
+      if (node->size_ == 0) {
+        Emit(kOPRETURNNONE);
+        break;
+      }
+      uint32_t base = next_;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i], Temp());
+      }
+      if (node->size_ == 1) {
+        Emit(kOPRETURN, base);
+      } else {
+        Emit(kOPRETURNTUPLE, base, node->size_);
+      }
+      break;
+    }
+    case kDEF: {
+      uint32_t base = next_;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i], Temp());
+      }
+      Emit(kOPDEF, node->index_, base, node->size_);
+      break;
+    }
+    default:
+      Expr(node, Temp());
+  }
+  next_ = save;
+}
+
+} // namespace
+
+void Compile(const Program &program, Module &module) {
+  Compiler(program, module).Run();
+}
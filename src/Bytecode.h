@@ -0,0 +1,79 @@
+#pragma once
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "Ast.h"
+#include "operator.h"
+#include "Value.h"
+#include <cstdint>
+#include <vector>
+
+// Register bytecode for the VM engine. Every function body (and the module)
+// compiles to a Code whose registers are a frame of Values; a, b and c name
+// registers, constants, names, jump targets or side-table entries as listed.
+enum OPCODE : uint8_t {
+  kOPLOADK,       // a = consts[b]
+  kOPLOADNAME,    // a = variable names[b] in frame slot c
+  kOPSTORENAME,   // variable names[a] in frame slot c = b
+  kOPAUGNAME,     // variable names[a] in frame slot c op= b, in place
+  kOPMOVE,        // a = b
+  kOPBINARY,      // a = b op c
+  kOPCOMPARE,     // a = bool(b op c)
+  kOPNEG,         // a = -b
+  kOPNOT,         // a = not b
+  kOPJUMP,        // goto a
+  kOPJUMPIFNOT,   // if not a: goto b
+  kOPJUMPIF,      // if a: goto b
+  kOPCALL,        // a = call calls[b] with arguments in c, c + 1, ...
+  kOPFSTRING,     // a = str(b) + str(b + 1) + ... for c registers
+  kOPUNPACK,      // assign registers b.. to the targets of assigns[a]
+  kOPDEF,         // define funcs[a] with its c defaults in b, b + 1, ...
+  kOPRETURN,      // return a
+  kOPRETURNTUPLE, // return (a, a + 1, ...) of b registers
+  kOPRETURNNONE
+};
+
+struct Instr {
+  OPCODE op_;
+  OPKIND kind_;
+  uint32_t a_;
+  uint32_t b_;
+  uint32_t c_;
+};
+
+struct CallSite {
+  uint32_t name_;
+  uint32_t npos_;
+  // Keyword names, for the arguments after the positional ones
+  std::vector<uint32_t> keywords_;
+};
+
+// A variable as the resolver left it: name index and frame slot
+struct Target {
+  uint32_t name_;
+  uint32_t slot_;
+};
+
+struct AssignSite {
+  uint32_t nvalues_;
+  // Targets per row, rightmost row first
+  std::vector<std::vector<Target>> rows_;
+};
+
+struct Code {
+  std::vector<Instr> instrs_;
+  uint32_t nregs_ = 0;
+};
+
+// Compiled form of a whole Program; constants extend program.consts_
+struct Module {
+  std::vector<Value> consts_;
+  std::vector<CallSite> calls_;
+  std::vector<AssignSite> assigns_;
+  // One Code per Program::funcs_ entry, then the module body
+  std::vector<Code> codes_;
+};
+
+void Compile(const Program &, Module &);
+
+#endif // BYTECODE_H
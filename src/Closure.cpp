@@ -0,0 +1,409 @@
+#include "Closure.h"
+#include "InnerFunc.h"
+#include "operator.h"
+#include "Options.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Expr = ClosureEngine::Expr;
+
+// Operands are evaluated left to right; a constant right operand is bound
+// by reference into the program's constant table
+template <class F>
+Expr Bind(Expr left, Expr right, F f) {
+  return [left = std::move(left), right = std::move(right), f] {
+    auto a = left();
+    return f(a, right());
+  };
+}
+template <class F>
+Expr BindConst(Expr left, const Value &right, F f) {
+  return [left = std::move(left), &right, f] {
+    return f(left(), right);
+  };
+}
+
+template <class F>
+Expr Specialize(Expr left, const Node *right, const Program &program, Expr compiled_right, F f) {
+  if (right->kind_ == kCONST) {
+    return BindConst(std::move(left), program.consts_[right->index_], f);
+  }
+  return Bind(std::move(left), std::move(compiled_right), f);
+}
+
+} // namespace
+
+ClosureEngine::ClosureEngine(const Program &program)
+    : program_(program), scope_(program.names_.size()), memo_(program) {
+  for (const auto &info : program_.funcs_) {
+    bodies_.push_back(CompileStmt(info.body_));
+  }
+  main_ = CompileStmt(program_.body_);
+}
+
+void ClosureEngine::Run() {
+  stack_.Enter();
+  main_();
+  if (options.memo_stats_) {
+    memo_.Dump();
+  }
+}
+
+ClosureEngine::Expr ClosureEngine::CompileBinary(const Node *node) {
+  auto left = CompileExpr(node->child_[0]);
+  const Node *rnode = node->child_[1];
+  auto right = rnode->kind_ == kCONST ? Expr() : CompileExpr(rnode);
+  switch (node->op_) {
+    case kADD:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return a + b; });
+    case kSUB:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return a - b; });
+    case kMUL:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return a * b; });
+    case kDIV:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return a / b; });
+    case kIDIV:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return ForceDiv(a, b); });
+    case kMOD:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return a % b; });
+    case kLT:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a < b); });
+    case kGT:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a > b); });
+    case kLE:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a <= b); });
+    case kGE:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a >= b); });
+    case kEQ:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a == b); });
+    case kNE:
+      return Specialize(left, rnode, program_, right, [](const Value &a, const Value &b) { return Value(a != b); });
+  }
+  return left;
+}
+
+ClosureEngine::Expr ClosureEngine::CompileCall(const Node *node) {
+  std::vector<Expr> positional;
+  std::vector<std::pair<uint32_t, Expr>> keywords;
+  for (uint32_t i = 0; i < node->size_; i++) {
+    const Node *arg = node->child_[i];
+    if (arg->kind_ == kKEYWORD) {
+      keywords.emplace_back(arg->index_, CompileExpr(arg->child_[0]));
+    } else {
+      positional.push_back(CompileExpr(arg));
+    }
+  }
+  const auto &funcname = program_.names_[node->index_];
+  return [this, &funcname, cache = CallCache(funcname), positional = std::move(positional),
+          keywords = std::move(keywords)]() mutable {
+    std::vector<Value> position;
+    std::vector<std::pair<uint32_t, Value>> keyboard;
+    for (const auto &arg : positional) {
+      auto val = arg();
+      if (val.IsTuple()) {
+        for (const auto &q : val.Tuple()) {
+          position.push_back(q);
+        }
+      } else {
+        position.push_back(std::move(val));
+      }
+    }
+    for (const auto &kw : keywords) {
+      keyboard.emplace_back(kw.first, kw.second());
+    }
+    return Invoke(funcname, cache, position, keyboard);
+  };
+}
+
+Value ClosureEngine::Invoke(const std::string &funcname, CallCache &cache, std::vector<Value> &position,
+                            std::vector<std::pair<uint32_t, Value>> &keyboard) {
+  if (cache.inner_ != kNOTINNER) {
+    for (auto &x : keyboard) {
+      position.push_back(std::move(x.second));
+    }
+    return Inner(cache.inner_, position);
+  }
+  auto def = cache.Resolve(func_, funcname);
+  if (def == nullptr) {
+    RuntimeError("NameError: name '" + funcname + "' is not defined");
+  }
+  size_t limit = options.recursion_limit_ != 0 ? options.recursion_limit_ : kDefaultRecursionLimit;
+  if (depth_ >= limit || stack_.Exhausted()) {
+    RuntimeError("RecursionError: maximum recursion depth exceeded");
+  }
+  const auto &info = program_.funcs_[def->index_];
+  scope_.LayerCreate(info.locals_.size());
+  func_.BindArgs(scope_, *def, info, position, keyboard);
+  auto memo = memo_.Find(def->index_, scope_);
+  if (memo != nullptr && memo->ready_) {
+    scope_.LayerDelete();
+    return memo->result_;
+  }
+  depth_++;
+  auto flow = bodies_[def->index_]();
+  depth_--;
+  scope_.LayerDelete();
+  // None when it fell off the end without a return
+  auto result = std::move(flow.value_);
+  if (memo != nullptr) {
+    memo->result_ = result;
+    memo->ready_ = true;
+  }
+  return result;
+}
+
+ClosureEngine::Expr ClosureEngine::CompileExpr(const Node *node) {
+  switch (node->kind_) {
+    case kCONST: {
+      const auto &val = program_.consts_[node->index_];
+      return [&val] { return val; };
+    }
+    case kNAME: {
+      // Unbound names read as None
+      uint32_t name = node->index_, slot = node->slot_;
+      return [this, name, slot] { return scope_.VarQuery(name, slot); };
+    }
+    case kNEG: {
+      auto operand = CompileExpr(node->child_[0]);
+      return [operand = std::move(operand)] { return -operand(); };
+    }
+    case kNOT: {
+      auto operand = CompileExpr(node->child_[0]);
+      return [operand = std::move(operand)] { return Value(!GetBool(operand())); };
+    }
+    case kBINARY:
+      return CompileBinary(node);
+    case kCOMPARE: {
+      if (node->size_ == 2) {
+        Node pair = *node;
+        pair.op_ = node->ops_[0];
+        return CompileBinary(&pair);
+      }
+      std::vector<Expr> operands;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        operands.push_back(CompileExpr(node->child_[i]));
+      }
+      const OPKIND *ops = node->ops_;
+      return [operands = std::move(operands), ops] {
+        auto left = operands[0]();
+        for (size_t i = 1; i < operands.size(); i++) {
+          auto right = operands[i]();
+          if (!CompareOp(ops[i - 1], left, right)) {
+            return Value(false);
+          }
+          left = std::move(right);
+        }
+        return Value(true);
+      };
+    }
+    case kAND:
+    case kOR: {
+      std::vector<Expr> operands;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        operands.push_back(CompileExpr(node->child_[i]));
+      }
+      // and stops at the first false operand, or at the first true one
+      bool is_and = node->kind_ == kAND;
+      return [operands = std::move(operands), is_and] {
+        for (const auto &operand : operands) {
+          if (GetBool(operand()) != is_and) {
+            return Value(!is_and);
+          }
+        }
+        return Value(is_and);
+      };
+    }
+    case kCALL:
+      return CompileCall(node);
+    case kFSTRING: {
+      std::vector<Expr> pieces;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        pieces.push_back(CompileExpr(node->child_[i]));
+      }
+      return [pieces = std::move(pieces)] {
+        std::string res;
+        for (const auto &piece : pieces) {
+          auto val = piece();
+          res += *BorrowString(val);
+        }
+        return Value(res);
+      };
+    }
+    default:
+      return [] { return Value(); };
+  }
+}
+
+ClosureEngine::Stmt ClosureEngine::CompileStmt(const Node *node) {
+  switch (node->kind_) {
+    case kBLOCK: {
+      std::vector<Stmt> stmts;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        stmts.push_back(CompileStmt(node->child_[i]));
+      }
+      if (stmts.size() == 1) {
+        return std::move(stmts[0]);
+      }
+      return [stmts = std::move(stmts)]() -> Completion {
+        for (const auto &stmt : stmts) {
+          auto flow = stmt();
+          if (flow.kind_ != kNOTFLOW) {
+            return flow;
+          }
+        }
+        return kNOTFLOW;
+      };
+    }
+    case kEXPR: {
+      std::vector<Expr> exprs;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        exprs.push_back(CompileExpr(node->child_[i]));
+      }
+      return [exprs = std::move(exprs)] {
+        for (const auto &expr : exprs) {
+          expr();
+        }
+        return kNOTFLOW;
+      };
+    }
+    case kASSIGN: {
+      const Node *values = node->child_[0];
+      if (node->size_ == 2 && values->size_ == 1 && node->child_[1]->size_ == 1) {
+        // x = value
+        const Node *target = node->child_[1]->child_[0];
+        uint32_t name = target->index_, slot = target->slot_;
+        auto value = CompileExpr(values->child_[0]);
+        return [this, name, slot, value = std::move(value)] {
+          scope_.VarSet(name, slot, value());
+          return kNOTFLOW;
+        };
+      }
+      std::vector<Expr> exprs;
+      for (uint32_t i = 0; i < values->size_; i++) {
+        exprs.push_back(CompileExpr(values->child_[i]));
+      }
+      std::vector<std::vector<const Node *>> rows;
+      for (uint32_t i = 1; i < node->size_; i++) {
+        rows.emplace_back(node->child_[i]->child_, node->child_[i]->child_ + node->child_[i]->size_);
+      }
+      return [this, exprs = std::move(exprs), rows = std::move(rows)] {
+        std::vector<Value> values;
+        for (const auto &expr : exprs) {
+          auto val = expr();
+          if (val.IsTuple()) {
+            for (const auto &q : val.Tuple()) {
+              values.push_back(q);
+            }
+          } else {
+            values.push_back(std::move(val));
+          }
+        }
+        for (const auto &targets : rows) {
+          if (targets.size() == 1 && values.size() != 1) {
+            // a = 1, 2 binds the whole tuple
+            scope_.VarSet(targets[0]->index_, targets[0]->slot_, Value(std::vector<Value>(values)));
+            continue;
+          }
+          if (targets.size() != values.size()) {
+            RuntimeError("ValueError: expected " + std::to_string(targets.size()) + " values to unpack, got " +
+                         std::to_string(values.size()));
+          }
+          for (size_t j = 0; j < targets.size(); j++) {
+            scope_.VarSet(targets[j]->index_, targets[j]->slot_, values[j]);
+          }
+        }
+        return kNOTFLOW;
+      };
+    }
+    case kAUGASSIGN: {
+      uint32_t name = node->index_, slot = node->slot_;
+      auto value = CompileExpr(node->child_[0]);
+      OPKIND op = node->op_;
+      return [this, name, slot, value = std::move(value), op] {
+        auto y = value();
+        AugmentOp(op, scope_.VarSlot(name, slot), y);
+        return kNOTFLOW;
+      };
+    }
+    case kIF: {
+      std::vector<std::pair<Expr, Stmt>> arms;
+      for (uint32_t i = 0; i + 1 < node->size_; i += 2) {
+        arms.emplace_back(CompileExpr(node->child_[i]), CompileStmt(node->child_[i + 1]));
+      }
+      Stmt orelse = node->size_ % 2 == 1 ? CompileStmt(node->child_[node->size_ - 1]) : Stmt();
+      return [arms = std::move(arms), orelse = std::move(orelse)]() -> Completion {
+        for (const auto &arm : arms) {
+          if (GetBool(arm.first())) {
+            return arm.second();
+          }
+        }
+        return orelse ? orelse() : kNOTFLOW;
+      };
+    }
+    case kWHILE: {
+      auto test = CompileExpr(node->child_[0]);
+      auto body = CompileStmt(node->child_[1]);
+      return [test = std::move(test), body = std::move(body)]() -> Completion {
+        while (GetBool(test())) {
+          auto flow = body();
+          if (flow.kind_ == kBREAK) {
+            break;
+          } else if (flow.kind_ == kRETURN) {
+            return flow;
+          }
+        }
+        return kNOTFLOW;
+      };
+    }
+    case kBREAKSTMT:
+      return [] { return kBREAK; };
+    case kCONTINUESTMT:
+      return [] { return kCONTINUE; };
+    case kRETURNSTMT: {
+      std::vector<Expr> exprs;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        exprs.push_back(CompileExpr(node->child_[i]));
+      }
+      return [exprs = std::move(exprs)] {
+        if (exprs.size() == 1) {
+          return Completion(kRETURN, exprs[0]());
+        } else if (exprs.empty()) {
+          return Completion(kRETURN);
+        }
+        std::vector<Value> valarray;
+        for (const auto &expr : exprs) {
+          valarray.push_back(expr());
+        }
+        return Completion(kRETURN, Value(std::move(valarray)));
+      };
+    }
+    case kDEF: {
+      std::vector<Expr> defaults;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        defaults.push_back(CompileExpr(node->child_[i]));
+      }
+      uint32_t index = node->index_;
+      return [this, defaults = std::move(defaults), index] {
+        // Defaults are evaluated once, when the def runs
+        const auto &info = program_.funcs_[index];
+        size_t nodefault = info.params_.size() - defaults.size();
+        std::vector<Value> initial;
+        for (size_t i = 0; i < info.params_.size(); i++) {
+          initial.push_back(i < nodefault ? Value() : defaults[i - nodefault]());
+        }
+        func_.AddFunc(program_.names_[info.name_], std::move(initial), index);
+        return kNOTFLOW;
+      };
+    }
+    default: {
+      auto expr = CompileExpr(node);
+      return [expr = std::move(expr)] {
+        expr();
+        return kNOTFLOW;
+      };
+    }
+  }
+}
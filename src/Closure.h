@@ -0,0 +1,51 @@
+#pragma once
+#ifndef CLOSURE_H
+#define CLOSURE_H
+
+#include "Ast.h"
+#include "Func.h"
+#include "Interpreter.h"
+#include "Memo.h"
+#include "Scope.h"
+#include "StackGuard.h"
+#include "Value.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Engine for --engine=closure: every node is compiled once into a C++
+// closure that holds its compiled children, its operator and any constant
+// operand, so running a statement is a chain of direct calls.
+class ClosureEngine {
+private:
+  // Each Python call nests several native frames here
+  static constexpr size_t kDefaultRecursionLimit = 3000;
+
+public:
+  using Expr = std::function<Value()>;
+  using Stmt = std::function<Completion()>;
+
+private:
+  const Program &program_;
+  Scope scope_;
+  Function func_{};
+  Memo memo_;
+  // Compiled bodies, indexed like Program::funcs_
+  std::vector<Stmt> bodies_{};
+  Stmt main_{};
+  size_t depth_ = 0;
+  StackGuard stack_{};
+
+  Expr CompileExpr(const Node *);
+  Expr CompileBinary(const Node *);
+  Expr CompileCall(const Node *);
+  Stmt CompileStmt(const Node *);
+  Value Invoke(const std::string &, CallCache &, std::vector<Value> &, std::vector<std::pair<uint32_t, Value>> &);
+
+public:
+  explicit ClosureEngine(const Program &);
+  void Run();
+};
+
+#endif // CLOSURE_H
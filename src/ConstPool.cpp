@@ -0,0 +1,77 @@
+#include "ConstPool.h"
+#include "operator.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+// \n and \t become control characters; any other escaped character
+// (\\, \", \') stands for itself
+void AppendDecoded(std::string &res, const std::string &s, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; i++) {
+    if (s[i] != '\\') {
+      res += s[i];
+    } else if (++i < end) {
+      res += s[i] == 'n' ? '\n' : s[i] == 't' ? '\t' : s[i];
+    }
+  }
+}
+
+} // namespace
+
+void ConstPool::Build(antlr4::tree::ParseTree *root) {
+  std::vector<antlr4::tree::ParseTree *> stack{root};
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    if (auto atom = dynamic_cast<Python3Parser::AtomContext *>(node)) {
+      AddAtom(atom);
+    } else if (auto fstring = dynamic_cast<Python3Parser::Format_stringContext *>(node)) {
+      AddFormatString(fstring);
+    }
+    for (auto child : node->children) {
+      stack.push_back(child);
+    }
+  }
+}
+
+void ConstPool::AddAtom(Python3Parser::AtomContext *ctx) {
+  if (ctx->NUMBER()) {
+    auto s = ctx->NUMBER()->getText();
+    if (s.find('.') != s.npos) {
+      pool_.emplace(ctx, Value(GetFlout(s)));
+    } else {
+      pool_.emplace(ctx, Value(GetInt(s)));
+    }
+  } else if (ctx->NONE()) {
+    pool_.emplace(ctx, Value());
+  } else if (ctx->TRUE()) {
+    pool_.emplace(ctx, Value(true));
+  } else if (ctx->FALSE()) {
+    pool_.emplace(ctx, Value(false));
+  } else if (!ctx->STRING().empty()) {
+    std::string res;
+    for (const auto &x : ctx->STRING()) {
+      // Drop the quotes around each piece
+      auto s = x->getText();
+      AppendDecoded(res, s, 1, s.size() - 1);
+    }
+    pool_.emplace(ctx, Value(res));
+  }
+}
+
+void ConstPool::AddFormatString(Python3Parser::Format_stringContext *ctx) {
+  for (auto piece : ctx->FORMAT_STRING_LITERAL()) {
+    // {{ and }} stand for single braces
+    auto s = piece->getText();
+    std::string text, res;
+    for (size_t j = 0; j < s.size(); j++) {
+      text += s[j];
+      if ((s[j] == '{' || s[j] == '}') && j + 1 < s.size() && s[j + 1] == s[j]) {
+        j++;
+      }
+    }
+    AppendDecoded(res, text, 0, text.size());
+    pool_.emplace(piece, Value(res));
+  }
+}
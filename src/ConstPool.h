@@ -0,0 +1,30 @@
+#pragma once
+#ifndef CONSTPOOL_H
+#define CONSTPOOL_H
+
+#include "Python3Parser.h"
+#include "Value.h"
+#include <unordered_map>
+
+// Literals decoded once, before the program runs. Numbers are parsed,
+// adjacent string literals are joined and their escapes decoded, and
+// f-string text pieces are decoded the same way; lowering then picks each
+// one up by its parse-tree node.
+class ConstPool {
+private:
+  std::unordered_map<const antlr4::tree::ParseTree *, Value> pool_{};
+
+  void AddAtom(Python3Parser::AtomContext *);
+  void AddFormatString(Python3Parser::Format_stringContext *);
+
+public:
+  // Walk the whole tree and decode every literal in it
+  void Build(antlr4::tree::ParseTree *);
+  // The decoded literal of an atom or f-string text piece, or nullptr
+  const Value *Find(const antlr4::tree::ParseTree *node) const {
+    auto it = pool_.find(node);
+    return it == pool_.end() ? nullptr : &it->second;
+  }
+};
+
+#endif // CONSTPOOL_H
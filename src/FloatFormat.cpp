@@ -0,0 +1,83 @@
+#include "FloatFormat.h"
+#include "Options.h"
+#include <charconv>
+#include <cstdlib>
+#include <string>
+
+size_t FormatFixed(double x, char *buf, int precision) {
+  auto res = std::to_chars(buf, buf + kFloatBufSize, x, std::chars_format::fixed, precision);
+  return res.ptr - buf;
+}
+
+std::string FormatShortest(double x) {
+  char buf[64];
+  auto res = std::to_chars(buf, buf + sizeof(buf), x, std::chars_format::scientific);
+  std::string sci(buf, res.ptr);
+  auto epos = sci.find('e');
+  if (epos == sci.npos) {
+    // inf or nan
+    return sci;
+  }
+
+  int exp = std::atoi(sci.c_str() + epos + 1);
+  if (exp < -4 || exp >= 16) {
+    return sci;
+  }
+
+  // Place the point inside the shortest digit string
+  std::string sign, digits;
+  for (size_t i = 0; i < epos; i++) {
+    if (sci[i] == '-') {
+      sign = "-";
+    } else if (sci[i] != '.') {
+      digits += sci[i];
+    }
+  }
+  std::string res_str;
+  if (exp < 0) {
+    res_str = "0." + std::string(-exp - 1, '0') + digits;
+  } else {
+    if (digits.size() <= static_cast<size_t>(exp) + 1) {
+      digits.append(exp + 1 - digits.size(), '0');
+    }
+    std::string frac = digits.substr(exp + 1);
+    res_str = digits.substr(0, exp + 1) + "." + (frac.empty() ? "0" : frac);
+  }
+  return sign + res_str;
+}
+
+std::string FormatFloat(double x) {
+  if (options.float_repr_) {
+    return FormatShortest(x);
+  }
+  char buf[kFloatBufSize];
+  return std::string(buf, FormatFixed(x, buf));
+}
+
+double ParseFloat(const std::string &s) {
+  // The whitespace Python strips: space, \t, \n, \v, \f and \r
+  auto space = [](char ch) { return ch == ' ' || (ch >= '\t' && ch <= '\r'); };
+  const char *first = s.data(), *last = s.data() + s.size();
+  while (first < last && space(*first)) {
+    first++;
+  }
+  while (last > first && space(last[-1])) {
+    last--;
+  }
+  bool negative = false;
+  if (first < last && (*first == '+' || *first == '-')) {
+    negative = *first == '-';
+    first++;
+  }
+  double x = 0.0;
+  // from_chars takes a '-' of its own, so "--5" must be refused here
+  bool signed_again = first < last && (*first == '+' || *first == '-');
+  auto res = std::from_chars(first, last, x);
+  if (!signed_again && res.ec == std::errc::result_out_of_range && res.ptr == last) {
+    // Overflow to inf or underflow to 0, as strtod rounds them
+    x = std::strtod(std::string(first, last).c_str(), nullptr);
+  } else if (signed_again || res.ec != std::errc() || res.ptr != last) {
+    RuntimeError("ValueError: could not convert string to float: '" + s + "'");
+  }
+  return negative ? -x : x;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#ifndef FLOATFORMAT_H
+#define FLOATFORMAT_H
+
+#include <cstddef>
+#include <string>
+
+// Float <-> text conversions used by print, str(), f-strings and float().
+// Built on the shortest/fixed std::to_chars and std::from_chars kernels, so
+// no locale or printf machinery is involved and output is exactly rounded.
+
+// Upper bound on the characters FormatFixed writes (DBL_MAX in full)
+constexpr size_t kFloatBufSize = 400;
+
+// Fixed notation with `precision` decimals, identical to printf("%.*f");
+// returns the number of characters written to buf
+size_t FormatFixed(double, char *buf, int precision = 6);
+
+// Shortest text that reads back as the same double, in Python repr style
+// (1.5, 100.0, 1e-05, 1e+22)
+std::string FormatShortest(double);
+
+// How str() and f-strings show a float: six decimals like print, or the
+// shortest round-trip form when --float-repr is given
+std::string FormatFloat(double);
+
+// Parse a float literal or float() argument. Surrounding whitespace and a
+// single leading sign are accepted; anything else is a ValueError.
+double ParseFloat(const std::string &);
+
+#endif // FLOATFORMAT_H
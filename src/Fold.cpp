@@ -0,0 +1,244 @@
+#include "Fold.h"
+#include "operator.h"
+#include "Options.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Folded strings stay in the constant table for the whole run
+constexpr size_t kMaxFoldedStr = 4096;
+
+bool IsNumber(const Value &val) {
+  return val.IsBool() || val.IsInt() || val.IsFloat();
+}
+
+class Folder {
+private:
+  Program &program_;
+  std::vector<std::string> log_{};
+
+  bool IsConst(const Node *node) const {
+    return node->kind_ == kCONST;
+  }
+  const Value &ConstOf(const Node *node) const {
+    return program_.consts_[node->index_];
+  }
+  std::string Repr(const Value &val) const {
+    return val.IsStr() ? "'" + val.Str() + "'" : GetString(val);
+  }
+  void Replace(Node *node, const Value &val, const std::string &what) {
+    log_.push_back("fold " + what + " -> " + Repr(val));
+    program_.consts_.push_back(val);
+    *node = Node{kCONST, kADD, static_cast<uint32_t>(program_.consts_.size() - 1), 0, nullptr, nullptr};
+  }
+  void Prune(Node *node, Node *keep, const std::string &what) {
+    log_.push_back("prune " + what);
+    if (keep != nullptr) {
+      *node = *keep;
+    } else {
+      *node = Node{kBLOCK, kADD, 0, 0, nullptr, nullptr};
+    }
+  }
+
+  bool CanApply(OPKIND, const Value &, const Value &) const;
+  void Expr(Node *);
+  void Stmt(Node *);
+
+public:
+  explicit Folder(Program &program) : program_(program) {}
+  void Run();
+};
+
+// Whether a op b is pure and cheap enough to evaluate now
+bool Folder::CanApply(OPKIND op, const Value &a, const Value &b) const {
+  if (op >= kLT) {
+    return (IsNumber(a) && IsNumber(b)) || (a.IsStr() && b.IsStr());
+  }
+  if (op == kIDIV || op == kMOD) {
+    // Float // and % truncate their operands to ints, so a divisor like 0.5
+    // divides by zero; those are left to run time
+    return a.IsInt() && b.IsInt() && GetBool(b);
+  }
+  if (IsNumber(a) && IsNumber(b)) {
+    return !(op == kDIV && !GetBool(b));
+  }
+  if (op == kADD && a.IsStr() && b.IsStr()) {
+    return a.Str().size() + b.Str().size() <= kMaxFoldedStr;
+  }
+  if (op == kMUL && (a.IsStr() != b.IsStr())) {
+    const Value &s = a.IsStr() ? a : b, &n = a.IsStr() ? b : a;
+    if (n.IsBool() || n.GetType() == Value::kINT) {
+      long long count = n.IsBool() ? n.Bool() : n.SmallInt();
+      return count <= 0 || s.Str().size() * static_cast<unsigned long long>(count) <= kMaxFoldedStr;
+    }
+  }
+  return false;
+}
+
+void Folder::Expr(Node *node) {
+  for (uint32_t i = 0; i < node->size_; i++) {
+    Expr(node->child_[i]);
+  }
+  switch (node->kind_) {
+    case kNEG:
+      if (IsConst(node->child_[0]) && IsNumber(ConstOf(node->child_[0]))) {
+        const auto &val = ConstOf(node->child_[0]);
+        Replace(node, -val, "-" + Repr(val));
+      }
+      break;
+    case kBINARY: {
+      if (!IsConst(node->child_[0]) || !IsConst(node->child_[1])) {
+        break;
+      }
+      const auto &a = ConstOf(node->child_[0]), &b = ConstOf(node->child_[1]);
+      if (CanApply(node->op_, a, b)) {
+        Replace(node, BinaryOp(node->op_, a, b), Repr(a) + " " + OpName(node->op_) + " " + Repr(b));
+      }
+      break;
+    }
+    case kCOMPARE: {
+      std::string what = "";
+      for (uint32_t i = 0; i < node->size_; i++) {
+        if (!IsConst(node->child_[i]) ||
+            (i > 0 && !CanApply(node->ops_[i - 1], ConstOf(node->child_[i - 1]), ConstOf(node->child_[i])))) {
+          return;
+        }
+        what += (i > 0 ? std::string(" ") + OpName(node->ops_[i - 1]) + " " : "") + Repr(ConstOf(node->child_[i]));
+      }
+      bool res = true;
+      for (uint32_t i = 1; i < node->size_ && res; i++) {
+        res = CompareOp(node->ops_[i - 1], ConstOf(node->child_[i - 1]), ConstOf(node->child_[i]));
+      }
+      Replace(node, Value(res), what);
+      break;
+    }
+    case kAND:
+    case kOR: {
+      // Constants that cannot decide the result are dropped; one that does
+      // ends the chain, and becomes the result if nothing runs before it
+      bool decide = node->kind_ == kOR;
+      uint32_t size = 0;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Node *child = node->child_[i];
+        if (!IsConst(child)) {
+          node->child_[size++] = child;
+        } else if (GetBool(ConstOf(child)) == decide) {
+          if (size == 0) {
+            Replace(node, Value(decide), decide ? "or -> constant true operand" : "and -> constant false operand");
+            return;
+          }
+          node->child_[size++] = child;
+          break;
+        }
+      }
+      if (size == 0) {
+        Replace(node, Value(!decide), decide ? "or of false constants" : "and of true constants");
+      } else if (size != node->size_) {
+        log_.push_back(std::string("prune ") + (decide ? "or" : "and") + " operands: " +
+                       std::to_string(node->size_) + " -> " + std::to_string(size));
+        node->size_ = size;
+      }
+      break;
+    }
+    case kNOT:
+      if (IsConst(node->child_[0])) {
+        const auto &val = ConstOf(node->child_[0]);
+        Replace(node, Value(!GetBool(val)), "not " + Repr(val));
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void Folder::Stmt(Node *node) {
+  switch (node->kind_) {
+    case kBLOCK:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Stmt(node->child_[i]);
+      }
+      break;
+    case kIF: {
+      // Drop arms whose test is constant false; a constant true test turns
+      // its arm into the else branch and drops everything after it
+      uint32_t size = 0;
+      Node *other = node->size_ % 2 == 1 ? node->child_[node->size_ - 1] : nullptr;
+      for (uint32_t i = 0; i + 1 < node->size_; i += 2) {
+        Node *test = node->child_[i];
+        Expr(test);
+        if (IsConst(test) && !GetBool(ConstOf(test))) {
+          log_.push_back("prune if arm with false test");
+          continue;
+        }
+        if (IsConst(test)) {
+          log_.push_back("prune if arms after true test");
+          other = node->child_[i + 1];
+          break;
+        }
+        node->child_[size++] = test;
+        node->child_[size++] = node->child_[i + 1];
+      }
+      if (other != nullptr) {
+        node->child_[size++] = other;
+      }
+      node->size_ = size;
+      for (uint32_t i = 1; i < size; i += 2) {
+        Stmt(node->child_[i]);
+      }
+      if (size % 2 == 1) {
+        Stmt(node->child_[size - 1]);
+      }
+      if (size <= 1) {
+        Prune(node, size == 1 ? node->child_[0] : nullptr, "if statement");
+      }
+      break;
+    }
+    case kWHILE:
+      Expr(node->child_[0]);
+      if (IsConst(node->child_[0]) && !GetBool(ConstOf(node->child_[0]))) {
+        Prune(node, nullptr, "while loop with false test");
+      } else {
+        Stmt(node->child_[1]);
+      }
+      break;
+    case kEXPR:
+    case kASSIGN:
+    case kRETURNSTMT:
+    case kDEF:
+      // Assignment targets are kNAME lists, which folding leaves alone
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Expr(node->child_[i]);
+      }
+      break;
+    case kAUGASSIGN:
+      Expr(node->child_[0]);
+      break;
+    case kBREAKSTMT:
+    case kCONTINUESTMT:
+      break;
+    default:
+      Expr(node);
+      break;
+  }
+}
+
+void Folder::Run() {
+  for (auto &func : program_.funcs_) {
+    Stmt(func.body_);
+  }
+  Stmt(program_.body_);
+  if (options.dump_folds_) {
+    for (const auto &line : log_) {
+      std::cerr << line << "\n";
+    }
+    std::cerr << log_.size() << " folds\n";
+  }
+}
+
+} // namespace
+
+void Fold(Program &program) {
+  Folder(program).Run();
+}
@@ -0,0 +1,16 @@
+#pragma once
+#ifndef FOLD_H
+#define FOLD_H
+
+#include "Ast.h"
+
+// Compile-time simplification of a lowered Program, run once before any
+// engine sees it. Operators whose operands are all constants are evaluated
+// with the runtime's own operator semantics and replaced by the result, and
+// if/elif/while arms with a constant test are pruned. Anything that could
+// fail or build a large value (zero divisors, long string repeats, mixed
+// str/number arithmetic) is left for run time. Nodes are rewritten in place.
+// With --dump-folds every rewrite is listed on stderr.
+void Fold(Program &);
+
+#endif // FOLD_H
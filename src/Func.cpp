@@ -1,15 +1,40 @@
 #include "Func.h"
+#include <algorithm>
 
-std::vector<std::pair<std::string, std::any>> Function::GetInitial(const std::string &funcname) {
-  return initialval_[funcname];
+const Function::Def *Function::Find(const std::string &funcname) const {
+  auto it = defs_.find(funcname);
+  return it == defs_.end() ? nullptr : &it->second;
 }
 
-Python3Parser::SuiteContext* Function::GetSuite(const std::string &funcname) {
-  return suites_[funcname];
+void Function::AddFunc(const std::string &name, std::vector<Value> vals, uint32_t index) {
+  auto it = defs_.find(name);
+  if (it == defs_.end()) {
+    // Defs stay where they are in the map, so cached pointers to others
+    // remain valid; a new name invalidates nothing
+    defs_.emplace(name, Def{index, std::move(vals)});
+    return;
+  }
+  it->second = Def{index, std::move(vals)};
+  epoch_++;
 }
 
-void Function::AddFunc(const std::string &name, const std::vector<std::pair<std::string, std::any>> &vals, Python3Parser::SuiteContext* suitecontext) {
-  suites_[name] = suitecontext;
-  initialval_[name] = vals;
+void Function::BindArgs(Scope &scope, const Def &def, const FuncInfo &info, std::vector<Value> &position,
+                        std::vector<std::pair<uint32_t, Value>> &keyboard) const {
+  const auto &initval = def.initial_;
+  for (size_t i = 0; i < position.size() && i < initval.size(); i++) {
+    scope.VarRegister(i, std::move(position[i]));
+  }
+  for (size_t i = 0; i < keyboard.size(); i++) {
+    // The one lookup by name left: match the keyword against the frame's
+    // names. One the body never mentions could not be observed anyway.
+    auto it = std::find(info.locals_.begin(), info.locals_.end(), keyboard[i].first);
+    if (it != info.locals_.end()) {
+      scope.VarRegister(it - info.locals_.begin(), std::move(keyboard[i].second));
+    }
+  }
+  for (size_t i = position.size(); i < initval.size(); i++) {
+    if (!scope.IsRegistered(i)) {
+      scope.VarRegister(i, initval[i]);
+    }
+  }
 }
-
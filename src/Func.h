@@ -1,14 +1,63 @@
-#include "Python3Parser.h"
+#pragma once
+#ifndef FUNC_H
+#define FUNC_H
+
+#include "Ast.h"
+#include "InnerFunc.h"
+#include "Scope.h"
+#include "Value.h"
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 class Function {
+public:
+  // What a def bound a name to
+  struct Def {
+    // Index into Program::funcs_
+    uint32_t index_;
+    // Per parameter, its default or None
+    std::vector<Value> initial_;
+  };
+
 private:
-  std::unordered_map<std::string, Python3Parser::SuiteContext*> suites_;
-  std::unordered_map<std::string, std::vector<std::pair<std::string, std::any>>> initialval_{};
+  std::unordered_map<std::string, Def> defs_{};
+  // Moves on whenever a def rebinds a name that was already defined
+  uint64_t epoch_ = 1;
+
 public:
-  std::vector<std::pair<std::string, std::any>> GetInitial(const std::string &) ;
-  Python3Parser::SuiteContext* GetSuite(const std::string &) ;
   Function () {}
-  void AddFunc(const std::string &, const std::vector<std::pair<std::string, std::any>> &, Python3Parser::SuiteContext*);
-};
\ No newline at end of file
+  // The function defined under this name, or nullptr
+  const Def *Find(const std::string &) const;
+  uint64_t Epoch() const {
+    return epoch_;
+  }
+  void AddFunc(const std::string &, std::vector<Value>, uint32_t);
+  // Bind a call's arguments into the (already created) frame of `info`;
+  // keyword arguments are given by name index
+  void BindArgs(Scope &, const Def &, const FuncInfo &info, std::vector<Value> &,
+                std::vector<std::pair<uint32_t, Value>> &) const;
+};
+
+// Inline cache of one call site: the builtin its name denotes, or the
+// user function it resolved to while Function's epoch stays unchanged
+struct CallCache {
+  INNERFUNC inner_ = kNOTINNER;
+  uint64_t epoch_ = 0;
+  const Function::Def *def_ = nullptr;
+
+  CallCache() {}
+  explicit CallCache(const std::string &name) : inner_(FindInner(name)) {}
+  // The site's user function, or nullptr if the name is not defined
+  const Function::Def *Resolve(const Function &func, const std::string &name) {
+    if (epoch_ != func.Epoch()) {
+      def_ = func.Find(name);
+      epoch_ = def_ != nullptr ? func.Epoch() : 0;
+    }
+    return def_;
+  }
+};
+
+#endif // FUNC_H
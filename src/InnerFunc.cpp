@@ -1,66 +1,62 @@
 #include "InnerFunc.h"
-#include "Evalvisitor.h"
 #include "int2048.h"
 #include "operator.h"
-#include <any>
+#include "Output.h"
+#include "Value.h"
 #include <cassert>
 #include <cstddef>
-#include <iomanip>
-#include <ios>
-#include <iostream>
 #include <string>
 #include <vector>
 
-bool CheckInner(const std::string &s) {
-  return s == "print" || s == "int" || s == "float" || s == "str" || s == "bool";
+INNERFUNC FindInner(const std::string &s) {
+  if (s == "print") {
+    return kINNERPRINT;
+  } else if (s == "int") {
+    return kINNERINT;
+  } else if (s == "float") {
+    return kINNERFLOAT;
+  } else if (s == "str") {
+    return kINNERSTR;
+  } else if (s == "bool") {
+    return kINNERBOOL;
+  }
+  return kNOTINNER;
 }
 
-void PrintVal(std::any val, char ch) {
-  if (val.type() == typeid(sjtu::int2048)) {
-    std::cout << std::any_cast<sjtu::int2048>(val) << ch;
-  } else if (val.type() == typeid(std::string)) {
-    auto s = std::any_cast<std::string>(val);
-    for (int i = 0; i < s.size(); i++) {
-      if (s[i] == '\\') {
-        i++;
-        if (i >= s.size()) {
-          break;
-        }
-        if (s[i] == 'n') {
-          std::cout << '\n';
-        } else if (s[i] == 't') {
-          std::cout << '\t';
-        } else if (s[i] == '\"') {
-          std::cout << '\"';
-        } else if (s[i] == '\'') {
-          std::cout << '\'';
-        } else {
-          std::cout << s[i];
-        }
-      } else {
-        std::cout << s[i];
+void PrintVal(const Value &val, char ch) {
+  switch (val.GetType()) {
+    case Value::kINT:
+      output.WriteInt(val.SmallInt());
+      break;
+    case Value::kBIGINT:
+      output.Write(std::string(val.BigInt()));
+      break;
+    case Value::kSTR:
+      output.Write(val.Str());
+      break;
+    case Value::kFLOAT:
+      output.WriteFloat(val.Float());
+      break;
+    case Value::kBOOL:
+      output.Write(val.Bool() ? "True" : "False", val.Bool() ? 4 : 5);
+      break;
+    case Value::kNONE:
+      output.Write("None", 4);
+      break;
+    case Value::kTUPLE: {
+      const auto &array = val.Tuple();
+      for (size_t i = 0; i + 1 < array.size(); i++) {
+        PrintVal(array[i], ' ');
       }
+      PrintVal(array.back(), ch);
+      return;
     }
-    std::cout << ch;
-  } else if (val.type() == typeid(double)) {
-    std::cout << std::fixed << std::setprecision(6) << std::any_cast<double>(val) << ch;
-  } else if (val.type() == typeid(bool)) {
-    std::cout << (std::any_cast<bool>(val) ? "True" : "False") << ch;
-  } else if (!val.has_value()){
-    std::cout << "None" << ch;
-  } else if (val.type() == typeid(std::vector<std::any>)){
-    auto array = std::any_cast<std::vector<std::any>>(val);
-    for (size_t i = 0; i + 1 < array.size(); i++) {
-      PrintVal(array[i], ' ');
-    }
-    PrintVal(array.back(), ch);
   }
+  output.Put(ch);
 }
 
-std::any Inner(const std::string &funcname, const std::vector<std::any> &val) {
-  // std::cerr << "INNER!!!!!!!!!!!!\n";
-  if (funcname == "print") {
-    // std::cerr << "Print!!\n";
+Value Inner(INNERFUNC func, const std::vector<Value> &val) {
+  if (func == kINNERPRINT) {
     for (size_t i = 0; i < val.size(); i++) {
       if (i + 1 < val.size()) {
         PrintVal(val[i], ' ');
@@ -69,19 +65,21 @@ std::any Inner(const std::string &funcname, const std::vector<std::any> &val) {
       }
     }
     if (val.empty()) {
-      std::cout << "\n";
+      output.Put('\n');
     }
-    return kNOTFLOW;
-  } else if (funcname == "int") {
-    return GetInt(val[0]);
-  } else if (funcname == "str") {
-    return GetString(val[0]);
-  } else if (funcname == "bool") {
-    return GetBool(val[0]);
-  } else if (funcname == "float") {
-    return GetFlout(val[0]);
+    output.EndLine();
+    return Value();
+  } else if (func == kINNERINT) {
+    // Conversions to the type already held share the stored payload
+    return val[0].IsInt() ? val[0] : Value(GetInt(val[0]));
+  } else if (func == kINNERSTR) {
+    return val[0].IsStr() ? val[0] : Value(GetString(val[0]));
+  } else if (func == kINNERBOOL) {
+    return val[0].IsBool() ? val[0] : Value(GetBool(val[0]));
+  } else if (func == kINNERFLOAT) {
+    return val[0].IsFloat() ? val[0] : Value(GetFlout(val[0]));
   } else {
     assert("INVALID INNER FUNC" == 0);
-    return std::any();
+    return Value();
   }
-}
\ No newline at end of file
+}
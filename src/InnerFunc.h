@@ -2,12 +2,15 @@
 #ifndef INNERFUNC_H
 #define INNERFUNC_H
 
-#include <any>
+#include "Value.h"
 #include <string>
 #include <vector>
 
-bool CheckInner(const std::string &);
+enum INNERFUNC {kNOTINNER, kINNERPRINT, kINNERINT, kINNERFLOAT, kINNERSTR, kINNERBOOL};
 
-std::any Inner(const std::string &, const std::vector<std::any> &);
+// The builtin a name refers to; builtins shadow user functions
+INNERFUNC FindInner(const std::string &);
+
+Value Inner(INNERFUNC, const std::vector<Value> &);
 
 #endif // INNERFUNC_H
\ No newline at end of file
@@ -0,0 +1,415 @@
+#include "Interpreter.h"
+#include "InnerFunc.h"
+#include "operator.h"
+#include "Options.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// x op y on two small ints; false when the result needs the generic kernel
+// (overflow into a big int, a zero divisor, LLONG_MIN // -1)
+bool SmallIntOp(OPKIND op, long long x, long long y, long long &res) {
+  switch (op) {
+    case kADD:
+      return !__builtin_add_overflow(x, y, &res);
+    case kSUB:
+      return !__builtin_sub_overflow(x, y, &res);
+    case kMUL:
+      return !__builtin_mul_overflow(x, y, &res);
+    case kIDIV:
+    case kMOD:
+      if (y == 0 || (x == LLONG_MIN && y == -1)) {
+        return false;
+      }
+      // Floor toward -inf, as the generic kernels do
+      res = op == kIDIV ? x / y : x % y;
+      if (x % y != 0 && ((x < 0) != (y < 0))) {
+        res = op == kIDIV ? res - 1 : res + y;
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+double FloatOp(OPKIND op, double x, double y) {
+  switch (op) {
+    case kADD:
+      return x + y;
+    case kSUB:
+      return x - y;
+    case kMUL:
+      return x * y;
+    default:
+      return x / y;
+  }
+}
+
+// <= and >= are the negations of > and <, as CompareOp defines them
+template <class T>
+bool CompareAs(OPKIND op, T x, T y) {
+  switch (op) {
+    case kLT:
+      return x < y;
+    case kGT:
+      return x > y;
+    case kLE:
+      return !(x > y);
+    case kGE:
+      return !(x < y);
+    case kEQ:
+      return x == y;
+    default:
+      return x != y;
+  }
+}
+
+} // namespace
+
+Interpreter::Interpreter(Program &program)
+    : program_(program), scope_(program.names_.size()), jit_(program), memo_(program) {
+  for (auto name : program_.calls_) {
+    calls_.emplace_back(program_.names_[name]);
+  }
+}
+
+void Interpreter::Run() {
+  stack_.Enter();
+  Exec(program_.body_);
+  if (options.quicken_stats_) {
+    DumpSites();
+  }
+  if (options.memo_stats_) {
+    memo_.Dump();
+  }
+}
+
+void Interpreter::Quicken(Node *node, const Value &left, const Value &right) {
+  // A recursive call may have rewritten the node while its operands ran
+  if (node->deopts_ >= kMaxDeopts || (node->kind_ != kBINARY && node->kind_ != kCOMPARE)) {
+    return;
+  }
+  bool binary = node->kind_ == kBINARY;
+  if (left.GetType() == Value::kINT && right.GetType() == Value::kINT) {
+    node->kind_ = binary ? kBINARYINT : kCOMPAREINT;
+  } else if (left.IsFloat() && right.IsFloat() && (!binary || node->op_ <= kDIV)) {
+    // Float // and % truncate through big ints; they stay generic
+    node->kind_ = binary ? kBINARYFLOAT : kCOMPAREFLOAT;
+  } else {
+    return;
+  }
+  Site(node).specializations_++;
+}
+
+void Interpreter::Deopt(Node *node) {
+  if (node->kind_ == GenericKind(node->kind_)) {
+    return;
+  }
+  node->kind_ = GenericKind(node->kind_);
+  node->deopts_++;
+  Site(node).deopts_++;
+}
+
+Interpreter::SiteStats &Interpreter::Site(const Node *node) {
+  auto it = sites_.find(node);
+  if (it == sites_.end()) {
+    it = sites_.emplace(node, SiteStats{static_cast<uint32_t>(sites_.size())}).first;
+  }
+  return it->second;
+}
+
+void Interpreter::DumpSites() const {
+  std::vector<std::pair<const Node *, SiteStats>> sites(sites_.begin(), sites_.end());
+  std::sort(sites.begin(), sites.end(),
+            [](const auto &a, const auto &b) { return a.second.order_ < b.second.order_; });
+  for (const auto &site : sites) {
+    const Node *node = site.first;
+    bool binary = GenericKind(node->kind_) == kBINARY;
+    const char *state = node->kind_ == kBINARYINT || node->kind_ == kCOMPAREINT       ? "int"
+                        : node->kind_ == kBINARYFLOAT || node->kind_ == kCOMPAREFLOAT ? "float"
+                                                                                      : "generic";
+    std::cerr << "site " << site.second.order_ << ": " << (binary ? "binary " : "compare ")
+              << OpName(binary ? node->op_ : node->ops_[0]) << " now " << state << ", "
+              << site.second.specializations_ << " specializations, " << site.second.deopts_ << " deopts\n";
+  }
+  std::cerr << sites.size() << " quickened sites\n";
+}
+
+Value Interpreter::Eval(Node *node) {
+  switch (node->kind_) {
+    case kCONST:
+      return program_.consts_[node->index_];
+    case kNAME: {
+      // Unbound names read as None
+      return scope_.VarQuery(node->index_, node->slot_);
+    }
+    case kNEG:
+      return -Eval(node->child_[0]);
+    case kBINARY: {
+      auto left = Eval(node->child_[0]);
+      auto right = Eval(node->child_[1]);
+      Quicken(node, left, right);
+      return BinaryOp(node->op_, left, right);
+    }
+    case kBINARYINT: {
+      auto left = Eval(node->child_[0]);
+      auto right = Eval(node->child_[1]);
+      if (left.GetType() == Value::kINT && right.GetType() == Value::kINT) {
+        long long res;
+        if (node->op_ == kDIV) {
+          return Value(double(left.SmallInt()) / double(right.SmallInt()));
+        } else if (SmallIntOp(node->op_, left.SmallInt(), right.SmallInt(), res)) {
+          return Value(res);
+        }
+      } else {
+        Deopt(node);
+      }
+      return BinaryOp(node->op_, left, right);
+    }
+    case kBINARYFLOAT: {
+      auto left = Eval(node->child_[0]);
+      auto right = Eval(node->child_[1]);
+      if (left.IsFloat() && right.IsFloat()) {
+        return Value(FloatOp(node->op_, left.Float(), right.Float()));
+      }
+      Deopt(node);
+      return BinaryOp(node->op_, left, right);
+    }
+    case kCOMPAREINT: {
+      auto left = Eval(node->child_[0]);
+      auto right = Eval(node->child_[1]);
+      if (left.GetType() == Value::kINT && right.GetType() == Value::kINT) {
+        return Value(CompareAs(node->ops_[0], left.SmallInt(), right.SmallInt()));
+      }
+      Deopt(node);
+      return Value(CompareOp(node->ops_[0], left, right));
+    }
+    case kCOMPAREFLOAT: {
+      auto left = Eval(node->child_[0]);
+      auto right = Eval(node->child_[1]);
+      if (left.IsFloat() && right.IsFloat()) {
+        return Value(CompareAs(node->ops_[0], left.Float(), right.Float()));
+      }
+      Deopt(node);
+      return Value(CompareOp(node->ops_[0], left, right));
+    }
+    case kCOMPARE: {
+      if (node->size_ == 2) {
+        auto left = Eval(node->child_[0]);
+        auto right = Eval(node->child_[1]);
+        Quicken(node, left, right);
+        return Value(CompareOp(node->ops_[0], left, right));
+      }
+      auto left = Eval(node->child_[0]);
+      for (uint32_t i = 1; i < node->size_; i++) {
+        auto right = Eval(node->child_[i]);
+        if (!CompareOp(node->ops_[i - 1], left, right)) {
+          return Value(false);
+        }
+        left = std::move(right);
+      }
+      return Value(true);
+    }
+    case kAND:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        if (!GetBool(Eval(node->child_[i]))) {
+          return Value(false);
+        }
+      }
+      return Value(true);
+    case kOR:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        if (GetBool(Eval(node->child_[i]))) {
+          return Value(true);
+        }
+      }
+      return Value(false);
+    case kNOT:
+      return Value(!GetBool(Eval(node->child_[0])));
+    case kCALL:
+      return Call(node);
+    case kFSTRING: {
+      std::string res;
+      for (uint32_t i = 0; i < node->size_; i++) {
+        auto piece = Eval(node->child_[i]);
+        res += *BorrowString(piece);
+      }
+      return Value(res);
+    }
+    default:
+      return Value();
+  }
+}
+
+void Interpreter::EvalSpread(const Node *list, std::vector<Value> &values) {
+  for (uint32_t i = 0; i < list->size_; i++) {
+    auto val = Eval(list->child_[i]);
+    if (val.IsTuple()) {
+      for (const auto &q : val.Tuple()) {
+        values.push_back(q);
+      }
+    } else {
+      values.push_back(std::move(val));
+    }
+  }
+}
+
+Value Interpreter::Call(const Node *node) {
+  const auto &funcname = program_.names_[node->index_];
+  std::vector<Value> position;
+  std::vector<std::pair<uint32_t, Value>> keyboard;
+  for (uint32_t i = 0; i < node->size_; i++) {
+    Node *arg = node->child_[i];
+    if (arg->kind_ == kKEYWORD) {
+      keyboard.emplace_back(arg->index_, Eval(arg->child_[0]));
+      continue;
+    }
+    auto val = Eval(arg);
+    if (val.IsTuple()) {
+      for (const auto &q : val.Tuple()) {
+        position.push_back(q);
+      }
+    } else {
+      position.push_back(std::move(val));
+    }
+  }
+  auto &cache = calls_[node->slot_];
+  if (cache.inner_ != kNOTINNER) {
+    for (auto &x : keyboard) {
+      position.push_back(std::move(x.second));
+    }
+    return Inner(cache.inner_, position);
+  }
+
+  auto def = cache.Resolve(func_, funcname);
+  if (def == nullptr) {
+    RuntimeError("NameError: name '" + funcname + "' is not defined");
+  }
+  size_t limit = options.recursion_limit_ != 0 ? options.recursion_limit_ : kDefaultRecursionLimit;
+  if (depth_ >= limit || stack_.Exhausted()) {
+    RuntimeError("RecursionError: maximum recursion depth exceeded");
+  }
+  const auto &info = program_.funcs_[def->index_];
+  scope_.LayerCreate(info.locals_.size());
+  func_.BindArgs(scope_, *def, info, position, keyboard);
+  auto memo = memo_.Find(def->index_, scope_);
+  if (memo != nullptr && memo->ready_) {
+    scope_.LayerDelete();
+    return memo->result_;
+  }
+  depth_++;
+  auto flow = Exec(info.body_);
+  depth_--;
+  scope_.LayerDelete();
+  // None when it fell off the end without a return
+  auto result = std::move(flow.value_);
+  if (memo != nullptr) {
+    memo->result_ = result;
+    memo->ready_ = true;
+  }
+  return result;
+}
+
+Completion Interpreter::Exec(Node *node) {
+  switch (node->kind_) {
+    case kBLOCK:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        auto flow = Exec(node->child_[i]);
+        if (flow.kind_ != kNOTFLOW) {
+          return flow;
+        }
+      }
+      return kNOTFLOW;
+    case kEXPR:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        Eval(node->child_[i]);
+      }
+      return kNOTFLOW;
+    case kASSIGN: {
+      std::vector<Value> values;
+      EvalSpread(node->child_[0], values);
+      for (uint32_t i = 1; i < node->size_; i++) {
+        const Node *targets = node->child_[i];
+        if (targets->size_ == 1 && values.size() != 1) {
+          // a = 1, 2 binds the whole tuple
+          const Node *target = targets->child_[0];
+          scope_.VarSet(target->index_, target->slot_, Value(std::vector<Value>(values)));
+          continue;
+        }
+        if (targets->size_ != values.size()) {
+          RuntimeError("ValueError: expected " + std::to_string(targets->size_) + " values to unpack, got " +
+                       std::to_string(values.size()));
+        }
+        for (uint32_t j = 0; j < targets->size_; j++) {
+          scope_.VarSet(targets->child_[j]->index_, targets->child_[j]->slot_, values[j]);
+        }
+      }
+      return kNOTFLOW;
+    }
+    case kAUGASSIGN: {
+      auto y = Eval(node->child_[0]);
+      // Update the stored value itself: a copy would share its box and force
+      // the in-place string/big int kernels to clone it first
+      AugmentOp(node->op_, scope_.VarSlot(node->index_, node->slot_), y);
+      return kNOTFLOW;
+    }
+    case kIF:
+      for (uint32_t i = 0; i + 1 < node->size_; i += 2) {
+        if (GetBool(Eval(node->child_[i]))) {
+          return Exec(node->child_[i + 1]);
+        }
+      }
+      if (node->size_ % 2 == 1) {
+        return Exec(node->child_[node->size_ - 1]);
+      }
+      return kNOTFLOW;
+    case kWHILE:
+      if (options.jit_ && jit_.Run(node, scope_)) {
+        return kNOTFLOW;
+      }
+      while (GetBool(Eval(node->child_[0]))) {
+        auto flow = Exec(node->child_[1]);
+        if (flow.kind_ == kBREAK) {
+          break;
+        } else if (flow.kind_ == kRETURN) {
+          return flow;
+        }
+      }
+      return kNOTFLOW;
+    case kBREAKSTMT:
+      return kBREAK;
+    case kCONTINUESTMT:
+      return kCONTINUE;
+    case kRETURNSTMT:
+      if (node->size_ == 0) {
+        return kRETURN;
+      } else if (node->size_ == 1) {
+        return Completion(kRETURN, Eval(node->child_[0]));
+      } else {
+        std::vector<Value> valarray;
+        for (uint32_t i = 0; i < node->size_; i++) {
+          valarray.push_back(Eval(node->child_[i]));
+        }
+        return Completion(kRETURN, Value(std::move(valarray)));
+      }
+    case kDEF: {
+      // Defaults are evaluated once, when the def runs
+      const auto &info = program_.funcs_[node->index_];
+      size_t nodefault = info.params_.size() - node->size_;
+      std::vector<Value> initial;
+      for (size_t i = 0; i < info.params_.size(); i++) {
+        initial.push_back(i < nodefault ? Value() : Eval(node->child_[i - nodefault]));
+      }
+      func_.AddFunc(program_.names_[info.name_], std::move(initial), node->index_);
+      return kNOTFLOW;
+    }
+    default:
+      Eval(node);
+      return kNOTFLOW;
+  }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "Ast.h"
+#include "Func.h"
+#include "Jit.h"
+#include "Memo.h"
+#include "Scope.h"
+#include "StackGuard.h"
+#include "Value.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum FLOWCONDITION {kCONTINUE, kBREAK, kNOTFLOW, kRETURN};
+
+// How a statement finished; a kRETURN carries the returned value, every
+// other kind leaves it None
+struct Completion {
+  FLOWCONDITION kind_;
+  Value value_;
+
+  Completion(FLOWCONDITION kind = kNOTFLOW, Value value = Value()) : kind_(kind), value_(std::move(value)) {}
+};
+
+// Walks a lowered Program directly: a switch on each node's kind, with
+// operators dispatched by OPKIND and literals read from the constant table.
+//
+// Arithmetic and comparison nodes are quickened: the first time a kBINARY
+// or two-operand kCOMPARE sees two small ints or two floats it is rewritten
+// in place into the matching specialized kind, which checks the operand
+// types and computes directly. A failed check turns the node back into the
+// generic kind; after kMaxDeopts of those it stays generic.
+class Interpreter {
+private:
+  // Each Python call nests several native frames here
+  static constexpr size_t kDefaultRecursionLimit = 3000;
+  static constexpr uint16_t kMaxDeopts = 4;
+
+  // Feedback of one quickened node, kept for --quicken-stats
+  struct SiteStats {
+    uint32_t order_;
+    uint32_t specializations_ = 0;
+    uint32_t deopts_ = 0;
+  };
+
+  Program &program_;
+  Scope scope_;
+  Function func_{};
+  LoopJit jit_;
+  Memo memo_;
+  // Per call site, numbered by the resolver
+  std::vector<CallCache> calls_{};
+  size_t depth_ = 0;
+  StackGuard stack_{};
+  // Updated only when a node changes kind
+  std::unordered_map<const Node *, SiteStats> sites_{};
+
+  Value Eval(Node *);
+  Value Call(const Node *);
+  // Evaluate a kLIST, spreading tuple values into their elements
+  void EvalSpread(const Node *, std::vector<Value> &);
+  Completion Exec(Node *);
+  // Specialize a generic node for the operand types it just saw, if it can
+  void Quicken(Node *, const Value &, const Value &);
+  void Deopt(Node *);
+  SiteStats &Site(const Node *);
+  void DumpSites() const;
+
+public:
+  // Quickening rewrites nodes of `program`
+  explicit Interpreter(Program &);
+  void Run();
+};
+
+#endif // INTERPRETER_H
@@ -0,0 +1,653 @@
+#include "Jit.h"
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+// x86-64 condition codes, as in the low nibble of Jcc; cc ^ 1 negates
+enum CONDITION : uint8_t {
+  kCCO = 0x0, kCCB = 0x2, kCCAE = 0x3, kCCE = 0x4, kCCNE = 0x5, kCCBE = 0x6, kCCA = 0x7,
+  kCCNS = 0x9, kCCP = 0xA, kCCL = 0xC, kCCGE = 0xD, kCCLE = 0xE, kCCG = 0xF
+};
+
+// Just the encodings the loop templates need. The frame pointer lives in
+// rdi, rbx keeps the entry rsp for bailouts, and intermediate results go
+// through rax/rcx/rdx/rsi, xmm0/xmm1 and the machine stack.
+class Assembler {
+private:
+  struct Label {
+    long pos_ = -1;
+    std::vector<size_t> fixups_;
+  };
+  std::vector<Label> labels_{};
+
+  void Imm32(uint32_t x) {
+    for (int i = 0; i < 4; i++) {
+      code_.push_back(static_cast<uint8_t>(x >> (8 * i)));
+    }
+  }
+  void Imm64(uint64_t x) {
+    Imm32(static_cast<uint32_t>(x));
+    Imm32(static_cast<uint32_t>(x >> 32));
+  }
+  void Rel32(int label) {
+    labels_[label].fixups_.push_back(code_.size());
+    Imm32(0);
+  }
+
+public:
+  std::vector<uint8_t> code_{};
+
+  void Bytes(std::initializer_list<uint8_t> bytes) {
+    code_.insert(code_.end(), bytes);
+  }
+  int NewLabel() {
+    labels_.emplace_back();
+    return labels_.size() - 1;
+  }
+  void Bind(int label) {
+    labels_[label].pos_ = code_.size();
+  }
+  void Jump(int label) {
+    Bytes({0xE9});
+    Rel32(label);
+  }
+  void JumpIf(uint8_t cc, int label) {
+    Bytes({0x0F, static_cast<uint8_t>(0x80 | cc)});
+    Rel32(label);
+  }
+  // Resolve every jump once all labels are bound
+  void Finish() {
+    for (const auto &label : labels_) {
+      for (auto at : label.fixups_) {
+        auto rel = static_cast<uint32_t>(label.pos_ - static_cast<long>(at + 4));
+        std::memcpy(&code_[at], &rel, 4);
+      }
+    }
+  }
+
+  void MovRaxImm(uint64_t x) {
+    Bytes({0x48, 0xB8});
+    Imm64(x);
+  }
+  void MovRdxImm(uint64_t x) {
+    Bytes({0x48, 0xBA});
+    Imm64(x);
+  }
+  void LoadRax(uint32_t slot) {
+    Bytes({0x48, 0x8B, 0x87});
+    Imm32(slot * 8);
+  }
+  void StoreRax(uint32_t slot) {
+    Bytes({0x48, 0x89, 0x87});
+    Imm32(slot * 8);
+  }
+  void LoadXmm0(uint32_t slot) {
+    Bytes({0xF2, 0x0F, 0x10, 0x87});
+    Imm32(slot * 8);
+  }
+  void StoreXmm0(uint32_t slot) {
+    Bytes({0xF2, 0x0F, 0x11, 0x87});
+    Imm32(slot * 8);
+  }
+  // xmm0 = (double)rax
+  void IntToFloat() {
+    Bytes({0xF2, 0x48, 0x0F, 0x2A, 0xC0});
+  }
+  // Spill xmm0 to the machine stack and back
+  void PushXmm0() {
+    Bytes({0x48, 0x83, 0xEC, 0x08, 0xF2, 0x0F, 0x11, 0x04, 0x24});
+  }
+  void PopXmm0() {
+    Bytes({0xF2, 0x0F, 0x10, 0x04, 0x24, 0x48, 0x83, 0xC4, 0x08});
+  }
+};
+
+class LoopCompiler {
+private:
+  const Program &program_;
+  Assembler as_{};
+  // Frame slot and type of each variable, by name index
+  std::unordered_map<uint32_t, std::pair<uint32_t, Value::Type>> vars_{};
+  uint32_t nvars_;
+  int bail_ = 0;
+  struct Targets {
+    int head_;
+    int exit_;
+  };
+  std::vector<Targets> loops_{};
+
+  // kINT or kFLOAT for a compilable arithmetic expression, else kNONE
+  Value::Type TypeOf(const Node *) const;
+  void Expr(const Node *);
+  void AsFloat(const Node *);
+  // Load both operands of a binary node: rax/rcx for ints, xmm0/xmm1 otherwise
+  void Operands(const Node *left, const Node *right, Value::Type type);
+  bool Arith(OPKIND, Value::Type);
+  bool Branch(const Node *, bool when, int target);
+  bool Stmt(const Node *);
+  bool Store(uint32_t name, Value::Type);
+
+public:
+  LoopCompiler(const Program &program, const std::vector<uint32_t> &vars, const std::vector<Value::Type> &types)
+      : program_(program), nvars_(vars.size()) {
+    for (uint32_t i = 0; i < vars.size(); i++) {
+      vars_[vars[i]] = {i, types[i]};
+    }
+  }
+  bool Run(const Node *);
+  std::vector<uint8_t> &Code() {
+    return as_.code_;
+  }
+};
+
+Value::Type LoopCompiler::TypeOf(const Node *node) const {
+  switch (GenericKind(node->kind_)) {
+    case kCONST: {
+      auto type = program_.consts_[node->index_].GetType();
+      return type == Value::kINT || type == Value::kFLOAT ? type : Value::kNONE;
+    }
+    case kNAME:
+      return vars_.at(node->index_).second;
+    case kNEG:
+      return TypeOf(node->child_[0]);
+    case kBINARY: {
+      auto left = TypeOf(node->child_[0]), right = TypeOf(node->child_[1]);
+      if (left == Value::kNONE || right == Value::kNONE) {
+        return Value::kNONE;
+      }
+      if (node->op_ == kDIV) {
+        return Value::kFLOAT;
+      }
+      if (node->op_ == kIDIV || node->op_ == kMOD) {
+        // Float // and % truncate through int2048; leave them to the interpreter
+        return left == Value::kINT && right == Value::kINT ? Value::kINT : Value::kNONE;
+      }
+      return left == Value::kINT && right == Value::kINT ? Value::kINT : Value::kFLOAT;
+    }
+    default:
+      return Value::kNONE;
+  }
+}
+
+void LoopCompiler::AsFloat(const Node *node) {
+  Expr(node);
+  if (TypeOf(node) == Value::kINT) {
+    as_.IntToFloat();
+  }
+}
+
+void LoopCompiler::Operands(const Node *left, const Node *right, Value::Type type) {
+  if (type == Value::kINT) {
+    Expr(left);
+    as_.Bytes({0x50});              // push rax
+    Expr(right);
+    as_.Bytes({0x48, 0x89, 0xC1});  // mov rcx, rax
+    as_.Bytes({0x58});              // pop rax
+  } else {
+    AsFloat(left);
+    as_.PushXmm0();
+    AsFloat(right);
+    as_.Bytes({0xF2, 0x0F, 0x10, 0xC8});  // movsd xmm1, xmm0
+    as_.PopXmm0();
+  }
+}
+
+// Result in rax or xmm0; int overflow and zero divisors bail
+bool LoopCompiler::Arith(OPKIND op, Value::Type type) {
+  if (type == Value::kFLOAT) {
+    uint8_t opcode = op == kADD ? 0x58 : op == kSUB ? 0x5C : op == kMUL ? 0x59 : 0x5E;
+    as_.Bytes({0xF2, 0x0F, opcode, 0xC1});  // addsd/subsd/mulsd/divsd xmm0, xmm1
+    return true;
+  }
+  switch (op) {
+    case kADD:
+      as_.Bytes({0x48, 0x01, 0xC8});  // add rax, rcx
+      break;
+    case kSUB:
+      as_.Bytes({0x48, 0x29, 0xC8});  // sub rax, rcx
+      break;
+    case kMUL:
+      as_.Bytes({0x48, 0x0F, 0xAF, 0xC1});  // imul rax, rcx
+      break;
+    case kIDIV:
+    case kMOD: {
+      int ok = as_.NewLabel(), floored = as_.NewLabel();
+      as_.Bytes({0x48, 0x85, 0xC9});  // test rcx, rcx
+      as_.JumpIf(kCCE, bail_);
+      as_.Bytes({0x48, 0x83, 0xF9, 0xFF});  // cmp rcx, -1
+      as_.JumpIf(kCCNE, ok);
+      as_.MovRdxImm(0x8000000000000000ULL);
+      as_.Bytes({0x48, 0x39, 0xD0});  // cmp rax, rdx
+      as_.JumpIf(kCCE, bail_);
+      as_.Bind(ok);
+      as_.Bytes({0x48, 0x99, 0x48, 0xF7, 0xF9});  // cqo; idiv rcx
+      // Round toward -inf: when the remainder's sign differs from the divisor's
+      as_.Bytes({0x48, 0x85, 0xD2});  // test rdx, rdx
+      as_.JumpIf(kCCE, floored);
+      as_.Bytes({0x48, 0x89, 0xD6, 0x48, 0x31, 0xCE});  // mov rsi, rdx; xor rsi, rcx
+      as_.JumpIf(kCCNS, floored);
+      as_.Bytes({0x48, 0xFF, 0xC8, 0x48, 0x01, 0xCA});  // dec rax; add rdx, rcx
+      as_.Bind(floored);
+      if (op == kMOD) {
+        as_.Bytes({0x48, 0x89, 0xD0});  // mov rax, rdx
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+  as_.JumpIf(kCCO, bail_);
+  return true;
+}
+
+void LoopCompiler::Expr(const Node *node) {
+  switch (GenericKind(node->kind_)) {
+    case kCONST: {
+      const auto &val = program_.consts_[node->index_];
+      if (val.GetType() == Value::kINT) {
+        as_.MovRaxImm(static_cast<uint64_t>(val.SmallInt()));
+      } else {
+        uint64_t bits;
+        double x = val.Float();
+        std::memcpy(&bits, &x, 8);
+        as_.MovRaxImm(bits);
+        as_.Bytes({0x66, 0x48, 0x0F, 0x6E, 0xC0});  // movq xmm0, rax
+      }
+      break;
+    }
+    case kNAME: {
+      auto var = vars_.at(node->index_);
+      if (var.second == Value::kINT) {
+        as_.LoadRax(var.first);
+      } else {
+        as_.LoadXmm0(var.first);
+      }
+      break;
+    }
+    case kNEG:
+      Expr(node->child_[0]);
+      if (TypeOf(node) == Value::kINT) {
+        as_.Bytes({0x48, 0xF7, 0xD8});  // neg rax
+        as_.JumpIf(kCCO, bail_);
+      } else {
+        as_.MovRaxImm(0x8000000000000000ULL);
+        as_.Bytes({0x66, 0x48, 0x0F, 0x6E, 0xC8});  // movq xmm1, rax
+        as_.Bytes({0x66, 0x0F, 0x57, 0xC1});        // xorpd xmm0, xmm1
+      }
+      break;
+    case kBINARY: {
+      auto type = TypeOf(node);
+      Operands(node->child_[0], node->child_[1], type);
+      Arith(node->op_, type);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Jump to target when the condition's truth equals `when`
+bool LoopCompiler::Branch(const Node *node, bool when, int target) {
+  switch (GenericKind(node->kind_)) {
+    case kCOMPARE: {
+      if (node->size_ != 2) {
+        return false;
+      }
+      auto left = TypeOf(node->child_[0]), right = TypeOf(node->child_[1]);
+      if (left == Value::kNONE || right == Value::kNONE) {
+        return false;
+      }
+      bool is_int = left == Value::kINT && right == Value::kINT;
+      Operands(node->child_[0], node->child_[1], is_int ? Value::kINT : Value::kFLOAT);
+      uint8_t cc;
+      switch (node->ops_[0]) {
+        case kLT:
+          cc = is_int ? kCCL : kCCB;
+          break;
+        case kGT:
+          cc = is_int ? kCCG : kCCA;
+          break;
+        case kLE:
+          cc = is_int ? kCCLE : kCCBE;
+          break;
+        case kGE:
+          cc = is_int ? kCCGE : kCCAE;
+          break;
+        case kEQ:
+          cc = kCCE;
+          break;
+        default:
+          cc = kCCNE;
+      }
+      if (is_int) {
+        as_.Bytes({0x48, 0x39, 0xC8});  // cmp rax, rcx
+      } else {
+        as_.Bytes({0x66, 0x0F, 0x2E, 0xC1});  // ucomisd xmm0, xmm1
+        as_.JumpIf(kCCP, bail_);
+      }
+      as_.JumpIf(when ? cc : cc ^ 1, target);
+      return true;
+    }
+    case kNOT:
+      return Branch(node->child_[0], !when, target);
+    case kAND:
+    case kOR: {
+      // The operand that decides the result early jumps past the rest
+      bool decide = node->kind_ == kOR;
+      int done = as_.NewLabel();
+      for (uint32_t i = 0; i + 1 < node->size_; i++) {
+        if (!Branch(node->child_[i], decide, decide == when ? target : done)) {
+          return false;
+        }
+      }
+      if (!Branch(node->child_[node->size_ - 1], when, target)) {
+        return false;
+      }
+      as_.Bind(done);
+      return true;
+    }
+    case kCONST:
+      if (program_.consts_[node->index_].IsBool()) {
+        if (program_.consts_[node->index_].Bool() == when) {
+          as_.Jump(target);
+        }
+        return true;
+      }
+      [[fallthrough]];
+    default: {
+      auto type = TypeOf(node);
+      if (type == Value::kNONE) {
+        return false;
+      }
+      Expr(node);
+      if (type == Value::kINT) {
+        as_.Bytes({0x48, 0x85, 0xC0});  // test rax, rax
+      } else {
+        as_.Bytes({0x66, 0x0F, 0x57, 0xC9});  // xorpd xmm1, xmm1
+        as_.Bytes({0x66, 0x0F, 0x2E, 0xC1});  // ucomisd xmm0, xmm1
+        as_.JumpIf(kCCP, bail_);
+      }
+      as_.JumpIf(when ? kCCNE : kCCE, target);
+      return true;
+    }
+  }
+}
+
+bool LoopCompiler::Store(uint32_t name, Value::Type type) {
+  auto var = vars_.at(name);
+  // A type change would need a new signature; leave it to the interpreter
+  if (var.second != type) {
+    return false;
+  }
+  if (type == Value::kINT) {
+    as_.StoreRax(var.first);
+  } else {
+    as_.StoreXmm0(var.first);
+  }
+  return true;
+}
+
+bool LoopCompiler::Stmt(const Node *node) {
+  switch (GenericKind(node->kind_)) {
+    case kBLOCK:
+      for (uint32_t i = 0; i < node->size_; i++) {
+        if (!Stmt(node->child_[i])) {
+          return false;
+        }
+      }
+      return true;
+    case kASSIGN: {
+      const Node *values = node->child_[0];
+      if (node->size_ != 2 || values->size_ != 1 || node->child_[1]->size_ != 1) {
+        return false;
+      }
+      auto type = TypeOf(values->child_[0]);
+      if (type == Value::kNONE) {
+        return false;
+      }
+      Expr(values->child_[0]);
+      return Store(node->child_[1]->child_[0]->index_, type);
+    }
+    case kAUGASSIGN: {
+      // x op= y computes like x = x op y
+      Node name{kNAME, kADD, node->index_, 0, nullptr, nullptr};
+      Node *children[2] = {&name, node->child_[0]};
+      Node binary{kBINARY, node->op_, 0, 2, children, nullptr};
+      auto type = TypeOf(&binary);
+      if (type == Value::kNONE) {
+        return false;
+      }
+      Expr(&binary);
+      return Store(node->index_, type);
+    }
+    case kIF: {
+      int end = as_.NewLabel();
+      for (uint32_t i = 0; i + 1 < node->size_; i += 2) {
+        int next = as_.NewLabel();
+        if (!Branch(node->child_[i], false, next) || !Stmt(node->child_[i + 1])) {
+          return false;
+        }
+        as_.Jump(end);
+        as_.Bind(next);
+      }
+      if (node->size_ % 2 == 1 && !Stmt(node->child_[node->size_ - 1])) {
+        return false;
+      }
+      as_.Bind(end);
+      return true;
+    }
+    case kWHILE: {
+      Targets loop{as_.NewLabel(), as_.NewLabel()};
+      as_.Bind(loop.head_);
+      if (!Branch(node->child_[0], false, loop.exit_)) {
+        return false;
+      }
+      loops_.push_back(loop);
+      if (!Stmt(node->child_[1])) {
+        return false;
+      }
+      loops_.pop_back();
+      as_.Jump(loop.head_);
+      as_.Bind(loop.exit_);
+      return true;
+    }
+    case kBREAKSTMT:
+    case kCONTINUESTMT:
+      if (loops_.empty()) {
+        return false;
+      }
+      as_.Jump(node->kind_ == kBREAKSTMT ? loops_.back().exit_ : loops_.back().head_);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// int loop(uint64_t *frame): frame[0, n) holds the variables and
+// frame[n, 2n) their values at the start of the current outer iteration.
+// Returns 0 when the loop finished and 1 on a bailout.
+bool LoopCompiler::Run(const Node *loop) {
+  bail_ = as_.NewLabel();
+  Targets outer{as_.NewLabel(), as_.NewLabel()};
+  as_.Bytes({0x53, 0x48, 0x89, 0xE3});  // push rbx; mov rbx, rsp
+  as_.Bind(outer.head_);
+  for (uint32_t i = 0; i < nvars_; i++) {
+    as_.LoadRax(i);
+    as_.StoreRax(nvars_ + i);
+  }
+  if (!Branch(loop->child_[0], false, outer.exit_)) {
+    return false;
+  }
+  loops_.push_back(outer);
+  if (!Stmt(loop->child_[1])) {
+    return false;
+  }
+  as_.Jump(outer.head_);
+  as_.Bind(outer.exit_);
+  as_.Bytes({0x5B, 0x31, 0xC0, 0xC3});  // pop rbx; xor eax, eax; ret
+  as_.Bind(bail_);
+  as_.Bytes({0x48, 0x89, 0xDC, 0x5B});  // mov rsp, rbx; pop rbx
+  as_.Bytes({0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3});  // mov eax, 1; ret
+  as_.Finish();
+  return true;
+}
+
+// Collect the loop's variables; false if it holds anything the JIT skips
+bool CollectVars(const Node *node, std::vector<uint32_t> &vars, std::vector<uint32_t> &slots) {
+  switch (GenericKind(node->kind_)) {
+    case kNAME:
+    case kAUGASSIGN:
+      if (std::find(vars.begin(), vars.end(), node->index_) == vars.end()) {
+        vars.push_back(node->index_);
+        slots.push_back(node->slot_);
+      }
+      break;
+    case kCONST:
+    case kNEG:
+    case kBINARY:
+    case kCOMPARE:
+    case kAND:
+    case kOR:
+    case kNOT:
+    case kLIST:
+    case kBLOCK:
+    case kASSIGN:
+    case kIF:
+    case kWHILE:
+    case kBREAKSTMT:
+    case kCONTINUESTMT:
+      break;
+    default:
+      return false;
+  }
+  for (uint32_t i = 0; i < node->size_; i++) {
+    if (!CollectVars(node->child_[i], vars, slots)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+LoopJit::~LoopJit() {
+  for (const auto &page : pages_) {
+    munmap(page.first, page.second);
+  }
+}
+
+LoopJit::Entry LoopJit::Compile(const Node *node, const Loop &loop, const std::vector<Value::Type> &types) {
+  LoopCompiler compiler(program_, loop.vars_, types);
+  if (!compiler.Run(node)) {
+    return nullptr;
+  }
+  const auto &code = compiler.Code();
+  size_t pagesize = sysconf(_SC_PAGESIZE);
+  size_t size = (code.size() + pagesize - 1) / pagesize * pagesize;
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    return nullptr;
+  }
+  std::memcpy(mem, code.data(), code.size());
+  // Writable while emitting, executable (and no longer writable) to run
+  if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+    munmap(mem, size);
+    return nullptr;
+  }
+  pages_.emplace_back(mem, size);
+  return reinterpret_cast<Entry>(mem);
+}
+
+bool LoopJit::Run(const Node *node, Scope &scope) {
+  // At most this many type signatures are compiled per loop
+  constexpr size_t kMaxVersions = 4;
+  auto it = loops_.find(node);
+  if (it == loops_.end()) {
+    it = loops_.emplace(node, Loop()).first;
+    it->second.eligible_ = CollectVars(node, it->second.vars_, it->second.slots_);
+  }
+  Loop &loop = it->second;
+  if (!loop.eligible_) {
+    return false;
+  }
+
+  size_t n = loop.vars_.size();
+  std::vector<Value *> slots(n);
+  std::vector<Value::Type> types(n);
+  for (size_t i = 0; i < n; i++) {
+    if (!scope.VarFind(loop.vars_[i], loop.slots_[i])) {
+      return false;
+    }
+    slots[i] = &scope.VarSlot(loop.vars_[i], loop.slots_[i]);
+    types[i] = slots[i]->GetType();
+    if (types[i] != Value::kINT && types[i] != Value::kFLOAT) {
+      return false;
+    }
+  }
+  Entry code = nullptr;
+  bool found = false;
+  for (const auto &version : loop.versions_) {
+    if (version.types_ == types) {
+      code = version.code_;
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    if (loop.versions_.size() >= kMaxVersions) {
+      return false;
+    }
+    code = Compile(node, loop, types);
+    loop.versions_.push_back(Version{types, code});
+  }
+  if (code == nullptr) {
+    return false;
+  }
+
+  std::vector<uint64_t> frame(2 * n);
+  for (size_t i = 0; i < n; i++) {
+    if (types[i] == Value::kINT) {
+      frame[i] = static_cast<uint64_t>(slots[i]->SmallInt());
+    } else {
+      double x = slots[i]->Float();
+      std::memcpy(&frame[i], &x, 8);
+    }
+  }
+  bool bailed = code(frame.data()) != 0;
+  // After a bailout the interpreter redoes the interrupted iteration
+  size_t from = bailed ? n : 0;
+  for (size_t i = 0; i < n; i++) {
+    if (types[i] == Value::kINT) {
+      *slots[i] = Value(static_cast<long long>(frame[from + i]));
+    } else {
+      double x;
+      std::memcpy(&x, &frame[from + i], 8);
+      *slots[i] = Value(x);
+    }
+  }
+  return !bailed;
+}
+
+#else
+
+// No code generator for this target: every loop stays interpreted
+
+LoopJit::~LoopJit() {}
+
+LoopJit::Entry LoopJit::Compile(const Node *, const Loop &, const std::vector<Value::Type> &) {
+  return nullptr;
+}
+
+bool LoopJit::Run(const Node *, Scope &) {
+  return false;
+}
+
+#endif
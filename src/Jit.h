@@ -0,0 +1,60 @@
+#pragma once
+#ifndef JIT_H
+#define JIT_H
+
+#include "Ast.h"
+#include "Scope.h"
+#include "Value.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Baseline x86-64 JIT for while loops (--jit, tree engine only).
+//
+// A loop qualifies when it only does int/float arithmetic, comparisons,
+// assignments, if/elif/else, nested whiles and break/continue, and every
+// variable it touches holds a small int or a float when it is entered.
+// The loop is compiled once per such type signature into code that keeps
+// the variables in a native frame. Int overflow, a zero int divisor or a
+// NaN comparison bails out: the variables are reset to their values at the
+// start of the current outer iteration, which the interpreter then redoes.
+// That is safe because a compiled loop has no effects besides its variables.
+//
+// Code is only generated on x86-64 Linux; elsewhere Run always returns false.
+class LoopJit {
+private:
+  using Entry = int (*)(uint64_t *frame);
+
+  struct Version {
+    std::vector<Value::Type> types_;
+    // nullptr when this signature could not be compiled
+    Entry code_;
+  };
+  struct Loop {
+    bool eligible_ = true;
+    // Program name indices of every variable the loop touches
+    std::vector<uint32_t> vars_;
+    // Their frame slots, as the resolver gave them
+    std::vector<uint32_t> slots_;
+    std::vector<Version> versions_;
+  };
+
+  const Program &program_;
+  std::unordered_map<const Node *, Loop> loops_{};
+  std::vector<std::pair<void *, size_t>> pages_{};
+
+  Entry Compile(const Node *, const Loop &, const std::vector<Value::Type> &);
+
+public:
+  explicit LoopJit(const Program &program) : program_(program) {}
+  LoopJit(const LoopJit &) = delete;
+  LoopJit &operator=(const LoopJit &) = delete;
+  ~LoopJit();
+
+  // Run the whole loop natively and return true, or return false with the
+  // variables at the state the interpreter should continue the loop from
+  bool Run(const Node *loop, Scope &);
+};
+
+#endif // JIT_H
@@ -0,0 +1,330 @@
+#include "Lower.h"
+#include "ConstPool.h"
+#include "Options.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+class Lowering {
+private:
+  Program &program_;
+  ConstPool pool_{};
+  std::unordered_map<std::string, uint32_t> name_ids_{};
+
+  Node *NewNode(NODEKIND kind, const std::vector<Node *> &children, uint32_t index = 0, OPKIND op = kADD) {
+    auto node = program_.arena_.NewArray<Node>(1);
+    auto child = program_.arena_.NewArray<Node *>(children.size());
+    std::copy(children.begin(), children.end(), child);
+    *node = Node{kind, op, index, static_cast<uint32_t>(children.size()), child, nullptr};
+    return node;
+  }
+  uint32_t Name(const std::string &name) {
+    auto it = name_ids_.find(name);
+    if (it != name_ids_.end()) {
+      return it->second;
+    }
+    program_.names_.push_back(name);
+    return name_ids_[name] = program_.names_.size() - 1;
+  }
+  Node *Const(const Value &val) {
+    program_.consts_.push_back(val);
+    return NewNode(kCONST, {}, program_.consts_.size() - 1);
+  }
+
+  Node *Stmt(Python3Parser::StmtContext *);
+  Node *SmallStmt(Python3Parser::Small_stmtContext *);
+  Node *ExprStmt(Python3Parser::Expr_stmtContext *);
+  Node *FlowStmt(Python3Parser::Flow_stmtContext *);
+  Node *CompoundStmt(Python3Parser::Compound_stmtContext *);
+  Node *Funcdef(Python3Parser::FuncdefContext *);
+  Node *Suite(Python3Parser::SuiteContext *);
+
+  Node *Test(Python3Parser::TestContext *);
+  Node *OrTest(Python3Parser::Or_testContext *);
+  Node *AndTest(Python3Parser::And_testContext *);
+  Node *NotTest(Python3Parser::Not_testContext *);
+  Node *Comparison(Python3Parser::ComparisonContext *);
+  Node *ArithExpr(Python3Parser::Arith_exprContext *);
+  Node *Term(Python3Parser::TermContext *);
+  Node *Factor(Python3Parser::FactorContext *);
+  Node *AtomExpr(Python3Parser::Atom_exprContext *);
+  Node *Atom(Python3Parser::AtomContext *);
+  Node *FormatString(Python3Parser::Format_stringContext *);
+  Node *Testlist(Python3Parser::TestlistContext *);
+
+public:
+  explicit Lowering(Program &program) : program_(program) {}
+  void Run(Python3Parser::File_inputContext *);
+};
+
+void Lowering::Run(Python3Parser::File_inputContext *ctx) {
+  pool_.Build(ctx);
+  std::vector<Node *> stmts;
+  for (auto stmt : ctx->stmt()) {
+    stmts.push_back(Stmt(stmt));
+  }
+  program_.body_ = NewNode(kBLOCK, stmts);
+}
+
+Node *Lowering::Stmt(Python3Parser::StmtContext *ctx) {
+  if (ctx->simple_stmt()) {
+    return SmallStmt(ctx->simple_stmt()->small_stmt());
+  } else {
+    return CompoundStmt(ctx->compound_stmt());
+  }
+}
+
+Node *Lowering::SmallStmt(Python3Parser::Small_stmtContext *ctx) {
+  if (ctx->expr_stmt()) {
+    return ExprStmt(ctx->expr_stmt());
+  } else {
+    return FlowStmt(ctx->flow_stmt());
+  }
+}
+
+Node *Lowering::ExprStmt(Python3Parser::Expr_stmtContext *ctx) {
+  auto testlistarray = ctx->testlist();
+  if (testlistarray.size() == 1u) {
+    auto list = Testlist(testlistarray[0]);
+    list->kind_ = kEXPR;
+    return list;
+  }
+  if (auto aug = ctx->augassign()) {
+    auto target = Testlist(testlistarray[0]);
+    if (target->size_ != 1 || target->child_[0]->kind_ != kNAME) {
+      RuntimeError("SyntaxError: illegal expression for augmented assignment");
+    }
+    OPKIND op = aug->ADD_ASSIGN() ? kADD : aug->SUB_ASSIGN() ? kSUB : aug->MULT_ASSIGN() ? kMUL
+              : aug->DIV_ASSIGN() ? kDIV : aug->IDIV_ASSIGN() ? kIDIV : kMOD;
+    auto value = Test(testlistarray[1]->test(0));
+    return NewNode(kAUGASSIGN, {value}, target->child_[0]->index_, op);
+  }
+  std::vector<Node *> children{Testlist(testlistarray.back())};
+  for (int i = static_cast<int>(testlistarray.size()) - 2; i >= 0; i--) {
+    auto target = Testlist(testlistarray[i]);
+    for (uint32_t j = 0; j < target->size_; j++) {
+      if (target->child_[j]->kind_ != kNAME) {
+        RuntimeError("SyntaxError: cannot assign to expression");
+      }
+    }
+    children.push_back(target);
+  }
+  return NewNode(kASSIGN, children);
+}
+
+Node *Lowering::FlowStmt(Python3Parser::Flow_stmtContext *ctx) {
+  if (ctx->break_stmt()) {
+    return NewNode(kBREAKSTMT, {});
+  } else if (ctx->continue_stmt()) {
+    return NewNode(kCONTINUESTMT, {});
+  }
+  auto testlist = ctx->return_stmt()->testlist();
+  if (!testlist) {
+    return NewNode(kRETURNSTMT, {});
+  }
+  auto list = Testlist(testlist);
+  list->kind_ = kRETURNSTMT;
+  return list;
+}
+
+Node *Lowering::CompoundStmt(Python3Parser::Compound_stmtContext *ctx) {
+  if (auto if_stmt = ctx->if_stmt()) {
+    std::vector<Node *> children;
+    auto testarray = if_stmt->test();
+    auto suitearray = if_stmt->suite();
+    for (size_t i = 0; i < testarray.size(); i++) {
+      children.push_back(Test(testarray[i]));
+      children.push_back(Suite(suitearray[i]));
+    }
+    if (suitearray.size() == testarray.size() + 1) {
+      children.push_back(Suite(suitearray.back()));
+    }
+    return NewNode(kIF, children);
+  } else if (auto while_stmt = ctx->while_stmt()) {
+    return NewNode(kWHILE, {Test(while_stmt->test()), Suite(while_stmt->suite())});
+  } else {
+    return Funcdef(ctx->funcdef());
+  }
+}
+
+Node *Lowering::Funcdef(Python3Parser::FuncdefContext *ctx) {
+  FuncInfo info{Name(ctx->NAME()->getText()), {}, nullptr};
+  std::vector<Node *> defaults;
+  if (auto args = ctx->parameters()->typedargslist()) {
+    for (auto x : args->tfpdef()) {
+      info.params_.push_back(Name(x->NAME()->getText()));
+    }
+    for (auto x : args->test()) {
+      defaults.push_back(Test(x));
+    }
+  }
+  info.body_ = Suite(ctx->suite());
+  program_.funcs_.push_back(std::move(info));
+  return NewNode(kDEF, defaults, program_.funcs_.size() - 1);
+}
+
+Node *Lowering::Suite(Python3Parser::SuiteContext *ctx) {
+  if (ctx->simple_stmt()) {
+    return NewNode(kBLOCK, {SmallStmt(ctx->simple_stmt()->small_stmt())});
+  }
+  std::vector<Node *> stmts;
+  for (auto stmt : ctx->stmt()) {
+    stmts.push_back(Stmt(stmt));
+  }
+  return NewNode(kBLOCK, stmts);
+}
+
+Node *Lowering::Test(Python3Parser::TestContext *ctx) {
+  return OrTest(ctx->or_test());
+}
+
+Node *Lowering::OrTest(Python3Parser::Or_testContext *ctx) {
+  auto andtestarray = ctx->and_test();
+  if (andtestarray.size() == 1u) {
+    return AndTest(andtestarray[0]);
+  }
+  std::vector<Node *> children;
+  for (auto x : andtestarray) {
+    children.push_back(AndTest(x));
+  }
+  return NewNode(kOR, children);
+}
+
+Node *Lowering::AndTest(Python3Parser::And_testContext *ctx) {
+  auto nottestarray = ctx->not_test();
+  if (nottestarray.size() == 1u) {
+    return NotTest(nottestarray[0]);
+  }
+  std::vector<Node *> children;
+  for (auto x : nottestarray) {
+    children.push_back(NotTest(x));
+  }
+  return NewNode(kAND, children);
+}
+
+Node *Lowering::NotTest(Python3Parser::Not_testContext *ctx) {
+  if (ctx->NOT()) {
+    return NewNode(kNOT, {NotTest(ctx->not_test())});
+  }
+  return Comparison(ctx->comparison());
+}
+
+Node *Lowering::Comparison(Python3Parser::ComparisonContext *ctx) {
+  auto arritharray = ctx->arith_expr();
+  if (arritharray.size() == 1u) {
+    return ArithExpr(arritharray[0]);
+  }
+  std::vector<Node *> children;
+  for (auto x : arritharray) {
+    children.push_back(ArithExpr(x));
+  }
+  auto compoparray = ctx->comp_op();
+  auto ops = program_.arena_.NewArray<OPKIND>(compoparray.size());
+  for (size_t i = 0; i < compoparray.size(); i++) {
+    auto op = compoparray[i];
+    ops[i] = op->LESS_THAN() ? kLT : op->GREATER_THAN() ? kGT : op->EQUALS() ? kEQ
+           : op->GT_EQ() ? kGE : op->LT_EQ() ? kLE : kNE;
+  }
+  auto node = NewNode(kCOMPARE, children);
+  node->ops_ = ops;
+  return node;
+}
+
+Node *Lowering::ArithExpr(Python3Parser::Arith_exprContext *ctx) {
+  auto termarray = ctx->term();
+  auto addorsub_oparray = ctx->addorsub_op();
+  auto res = Term(termarray[0]);
+  for (size_t i = 1; i < termarray.size(); i++) {
+    OPKIND op = addorsub_oparray[i - 1]->ADD() ? kADD : kSUB;
+    res = NewNode(kBINARY, {res, Term(termarray[i])}, 0, op);
+  }
+  return res;
+}
+
+Node *Lowering::Term(Python3Parser::TermContext *ctx) {
+  auto factorarray = ctx->factor();
+  auto muldivmod_oparray = ctx->muldivmod_op();
+  auto res = Factor(factorarray[0]);
+  for (size_t i = 1; i < factorarray.size(); i++) {
+    auto opctx = muldivmod_oparray[i - 1];
+    OPKIND op = opctx->STAR() ? kMUL : opctx->DIV() ? kDIV : opctx->IDIV() ? kIDIV : kMOD;
+    res = NewNode(kBINARY, {res, Factor(factorarray[i])}, 0, op);
+  }
+  return res;
+}
+
+Node *Lowering::Factor(Python3Parser::FactorContext *ctx) {
+  if (!ctx->factor()) {
+    return AtomExpr(ctx->atom_expr());
+  }
+  auto operand = Factor(ctx->factor());
+  return ctx->MINUS() ? NewNode(kNEG, {operand}) : operand;
+}
+
+Node *Lowering::AtomExpr(Python3Parser::Atom_exprContext *ctx) {
+  if (!ctx->trailer()) {
+    return Atom(ctx->atom());
+  }
+  if (!ctx->atom()->NAME()) {
+    RuntimeError("SyntaxError: only named functions can be called");
+  }
+  std::vector<Node *> args;
+  if (auto arglist = ctx->trailer()->arglist()) {
+    for (auto x : arglist->argument()) {
+      auto testarray = x->test();
+      if (testarray.size() == 1u) {
+        args.push_back(Test(testarray[0]));
+      } else {
+        auto name = Test(testarray[0]);
+        if (name->kind_ != kNAME) {
+          RuntimeError("SyntaxError: expression cannot be a keyword argument");
+        }
+        args.push_back(NewNode(kKEYWORD, {Test(testarray[1])}, name->index_));
+      }
+    }
+  }
+  return NewNode(kCALL, args, Name(ctx->atom()->NAME()->getText()));
+}
+
+Node *Lowering::Atom(Python3Parser::AtomContext *ctx) {
+  if (ctx->NAME()) {
+    return NewNode(kNAME, {}, Name(ctx->NAME()->getText()));
+  } else if (auto literal = pool_.Find(ctx)) {
+    return Const(*literal);
+  } else if (ctx->test()) {
+    return Test(ctx->test());
+  } else {
+    return FormatString(ctx->format_string());
+  }
+}
+
+Node *Lowering::FormatString(Python3Parser::Format_stringContext *ctx) {
+  // Children come in source order: text pieces (decoded in the pool) and
+  // {testlist} fields between the quotes
+  std::vector<Node *> pieces;
+  for (auto child : ctx->children) {
+    if (auto field = dynamic_cast<Python3Parser::TestlistContext *>(child)) {
+      pieces.push_back(Test(field->test(0)));
+    } else if (auto text = pool_.Find(child)) {
+      pieces.push_back(Const(*text));
+    }
+  }
+  return NewNode(kFSTRING, pieces);
+}
+
+Node *Lowering::Testlist(Python3Parser::TestlistContext *ctx) {
+  std::vector<Node *> children;
+  for (auto x : ctx->test()) {
+    children.push_back(Test(x));
+  }
+  return NewNode(kLIST, children);
+}
+
+} // namespace
+
+void Lower(Python3Parser::File_inputContext *ctx, Program &program) {
+  Lowering(program).Run(ctx);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#ifndef LOWER_H
+#define LOWER_H
+
+#include "Ast.h"
+#include "Python3Parser.h"
+
+// Translate a parsed module into `program`. Operators become OPKIND codes,
+// literals are decoded into program.consts_ and names are interned, so the
+// parse tree can be freed as soon as this returns.
+void Lower(Python3Parser::File_inputContext *, Program &program);
+
+#endif // LOWER_H
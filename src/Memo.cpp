@@ -0,0 +1,249 @@
+#include "Memo.h"
+#include "InnerFunc.h"
+#include "Options.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+using NameSet = std::unordered_set<uint32_t>;
+
+void AddTargets(const Node *node, NameSet &names) {
+  if (node->kind_ == kASSIGN) {
+    for (uint32_t i = 1; i < node->size_; i++) {
+      for (uint32_t j = 0; j < node->child_[i]->size_; j++) {
+        names.insert(node->child_[i]->child_[j]->index_);
+      }
+    }
+  }
+  for (uint32_t i = 0; i < node->size_; i++) {
+    AddTargets(node->child_[i], names);
+  }
+}
+
+void AddAugTargets(const Node *node, NameSet &names) {
+  if (node->kind_ == kAUGASSIGN) {
+    names.insert(node->index_);
+  }
+  for (uint32_t i = 0; i < node->size_; i++) {
+    AddAugTargets(node->child_[i], names);
+  }
+}
+
+// Whether a function only touches `own` names and calls no print or def;
+// the user functions it calls are collected for the fixpoint
+bool LocallyPure(const Program &program, const Node *node, const NameSet &own, std::vector<uint32_t> &callees) {
+  switch (node->kind_) {
+    case kNAME:
+    case kAUGASSIGN:
+      if (own.count(node->index_) == 0) {
+        return false;
+      }
+      break;
+    case kASSIGN:
+      for (uint32_t i = 1; i < node->size_; i++) {
+        for (uint32_t j = 0; j < node->child_[i]->size_; j++) {
+          if (own.count(node->child_[i]->child_[j]->index_) == 0) {
+            return false;
+          }
+        }
+      }
+      break;
+    case kCALL: {
+      auto inner = FindInner(program.names_[node->index_]);
+      if (inner == kINNERPRINT) {
+        return false;
+      } else if (inner == kNOTINNER) {
+        callees.push_back(node->index_);
+      }
+      break;
+    }
+    case kDEF:
+      return false;
+    default:
+      break;
+  }
+  for (uint32_t i = 0; i < node->size_; i++) {
+    if (!LocallyPure(program, node->child_[i], own, callees)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Append a type tag and the payload; false for values that are not keys
+bool AppendKey(std::string &key, const Value &val) {
+  key += static_cast<char>(val.GetType());
+  switch (val.GetType()) {
+    case Value::kINT: {
+      long long x = val.SmallInt();
+      key.append(reinterpret_cast<const char *>(&x), sizeof(x));
+      return true;
+    }
+    case Value::kFLOAT: {
+      double x = val.Float();
+      key.append(reinterpret_cast<const char *>(&x), sizeof(x));
+      return true;
+    }
+    case Value::kBOOL:
+      key += val.Bool() ? '1' : '0';
+      return true;
+    case Value::kNONE:
+      return true;
+    case Value::kBIGINT:
+    case Value::kSTR: {
+      std::string s = val.GetType() == Value::kSTR ? val.Str() : std::string(val.BigInt());
+      size_t n = s.size();
+      key.append(reinterpret_cast<const char *>(&n), sizeof(n));
+      key += s;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+Memo::Memo(const Program &program) : program_(program), caches_(program.funcs_.size()) {
+  if (options.memo_.empty()) {
+    return;
+  }
+  // Names that may be bound as globals: module-level targets, and
+  // augmented targets a function does not also assign plainly, which an
+  // unbound name turns into globals
+  NameSet globals;
+  AddTargets(program_.body_, globals);
+  AddAugTargets(program_.body_, globals);
+  std::vector<NameSet> assigned(program_.funcs_.size());
+  for (size_t i = 0; i < program_.funcs_.size(); i++) {
+    const auto &info = program_.funcs_[i];
+    AddTargets(info.body_, assigned[i]);
+    NameSet aug;
+    AddAugTargets(info.body_, aug);
+    for (auto name : aug) {
+      bool param = std::find(info.params_.begin(), info.params_.end(), name) != info.params_.end();
+      if (!param && assigned[i].count(name) == 0) {
+        globals.insert(name);
+      }
+    }
+  }
+
+  std::vector<bool> pure(program_.funcs_.size());
+  std::vector<std::vector<uint32_t>> callees(program_.funcs_.size());
+  for (size_t i = 0; i < program_.funcs_.size(); i++) {
+    const auto &info = program_.funcs_[i];
+    NameSet own(info.params_.begin(), info.params_.end());
+    for (auto name : assigned[i]) {
+      if (globals.count(name) == 0) {
+        own.insert(name);
+      }
+    }
+    pure[i] = LocallyPure(program_, info.body_, own, callees[i]);
+  }
+  // A call is pure when every def of the callee's name is; drop functions
+  // until nothing changes, so recursion among pure functions stays pure
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t i = 0; i < program_.funcs_.size(); i++) {
+      if (!pure[i]) {
+        continue;
+      }
+      for (auto callee : callees[i]) {
+        bool defined = false, ok = true;
+        for (size_t j = 0; j < program_.funcs_.size(); j++) {
+          if (program_.funcs_[j].name_ == callee) {
+            defined = true;
+            ok = ok && pure[j];
+          }
+        }
+        if (!defined || !ok) {
+          pure[i] = false;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < program_.funcs_.size(); i++) {
+    const auto &name = program_.names_[program_.funcs_[i].name_];
+    if (std::find(options.memo_.begin(), options.memo_.end(), name) == options.memo_.end()) {
+      continue;
+    }
+    if (pure[i]) {
+      caches_[i].enabled_ = true;
+    } else {
+      std::cerr << "memo: " << name << " is not pure, calls are not cached\n";
+    }
+  }
+}
+
+Memo::Entry *Memo::Find(uint32_t func, Scope &scope) {
+  auto &cache = caches_[func];
+  if (!cache.enabled_) {
+    return nullptr;
+  }
+  const auto &params = program_.funcs_[func].params_;
+  std::string key;
+  for (uint32_t i = 0; i < params.size(); i++) {
+    if (!AppendKey(key, scope.VarQuery(params[i], i))) {
+      return nullptr;
+    }
+  }
+  auto it = cache.entries_.find(key);
+  if (it != cache.entries_.end()) {
+    if (!it->second.ready_) {
+      // The same arguments are already being computed further up
+      return nullptr;
+    }
+    cache.hits_++;
+    return &it->second;
+  }
+  cache.misses_++;
+  // A full cache keeps what it has; entries are never moved or dropped
+  if (cache.entries_.size() >= options.memo_size_) {
+    return nullptr;
+  }
+  return &cache.entries_[key];
+}
+
+void Memo::Dump() const {
+  for (size_t i = 0; i < caches_.size(); i++) {
+    const auto &cache = caches_[i];
+    if (cache.enabled_) {
+      std::cerr << "memo " << program_.names_[program_.funcs_[i].name_] << ": " << cache.hits_ << " hits, "
+                << cache.misses_ << " misses, " << cache.entries_.size() << " entries\n";
+    }
+  }
+}
+
+std::vector<std::string> MemoPragmas(const std::string &source) {
+  std::vector<std::string> names;
+  std::istringstream in(source);
+  std::string line;
+  bool marked = false;
+  while (std::getline(in, line)) {
+    auto start = line.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+      continue;
+    }
+    if (line.compare(start, 1, "#") == 0) {
+      auto text = line.find_first_not_of(" \t", start + 1);
+      marked = marked || (text != std::string::npos && line.compare(text, 5, "@memo") == 0);
+      continue;
+    }
+    if (marked && line.compare(start, 4, "def ") == 0) {
+      auto begin = line.find_first_not_of(" \t", start + 4);
+      auto end = line.find_first_of(" \t(", begin);
+      if (begin != std::string::npos && end != std::string::npos) {
+        names.push_back(line.substr(begin, end - begin));
+      }
+    }
+    marked = false;
+  }
+  return names;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef MEMO_H
+#define MEMO_H
+
+#include "Ast.h"
+#include "Scope.h"
+#include "Value.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Result caches for user functions picked with --memo=f,g or a `# @memo`
+// line right above their def. Only functions proven pure are cached: they
+// read and write nothing but their parameters and own locals (names that
+// can never be globals), define no functions, and call only int/float/str/
+// bool and other pure functions. Calls are keyed by the bound parameter
+// values when all are ints, floats, strs, bools or None.
+class Memo {
+public:
+  struct Entry {
+    Value result_;
+    // False while the call that will fill it is still running
+    bool ready_ = false;
+  };
+
+private:
+  struct Cache {
+    bool enabled_ = false;
+    std::unordered_map<std::string, Entry> entries_{};
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+  };
+
+  const Program &program_;
+  // Indexed like Program::funcs_
+  std::vector<Cache> caches_{};
+
+public:
+  explicit Memo(const Program &);
+  // The entry of this call, whose parameters are bound in the current scope
+  // layer; when it is not ready the caller runs the function and fills it.
+  // nullptr when the call is not cached.
+  Entry *Find(uint32_t func, Scope &);
+  // Hit and miss counts per memoized function, on stderr (--memo-stats)
+  void Dump() const;
+};
+
+// Names of the functions whose def follows a `# @memo` comment line
+std::vector<std::string> MemoPragmas(const std::string &source);
+
+#endif // MEMO_H
@@ -0,0 +1,77 @@
+#include "Options.h"
+#include "Output.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+Options options;
+
+namespace {
+
+// The value of a --name=N flag, which must be a plain non-negative integer
+size_t ParseCount(const std::string &name, const std::string &value) {
+  unsigned long long x = 0;
+  const char *first = value.data(), *last = first + value.size();
+  auto res = std::from_chars(first, last, x);
+  if (value.empty() || res.ec != std::errc() || res.ptr != last) {
+    RuntimeError("usage: " + name + "=N takes a non-negative integer, got '" + value + "'");
+  }
+  return x;
+}
+
+} // namespace
+
+void ParseOptions(int argc, const char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto pos = arg.find('=');
+    std::string name = arg.substr(0, pos);
+    std::string value = pos == arg.npos ? "" : arg.substr(pos + 1);
+    if (name == "--max-str-bytes") {
+      options.max_str_bytes_ = ParseCount(name, value);
+    } else if (name == "--recursion-limit") {
+      options.recursion_limit_ = ParseCount(name, value);
+    } else if (name == "--memo-size") {
+      options.memo_size_ = ParseCount(name, value);
+    } else if (name == "--memo") {
+      for (size_t begin = 0, end; begin <= value.size(); begin = end + 1) {
+        end = std::min(value.find(',', begin), value.size());
+        if (end > begin) {
+          options.memo_.push_back(value.substr(begin, end - begin));
+        }
+      }
+    } else if (name == "--memo-stats") {
+      options.memo_stats_ = true;
+    } else if (name == "--float-repr") {
+      options.float_repr_ = true;
+    } else if (name == "--dump-folds") {
+      options.dump_folds_ = true;
+    } else if (name == "--quicken-stats") {
+      options.quicken_stats_ = true;
+    } else if (name == "--jit") {
+      options.jit_ = true;
+    } else if (name == "--engine" && (value == "tree" || value == "vm" || value == "closure")) {
+      options.engine_ = value == "vm" ? kVMENGINE : value == "closure" ? kCLOSUREENGINE : kTREEENGINE;
+    } else if (name == "--flush" && (value == "line" || value == "block" || value == "exit")) {
+      output.SetPolicy(value == "line" ? kFLUSHLINE : value == "block" ? kFLUSHBLOCK : kFLUSHEXIT);
+    } else {
+      std::cerr << "unknown option " << arg << "\n";
+    }
+  }
+  if (options.jit_ && options.engine_ != kTREEENGINE) {
+    std::cerr << "--jit only applies to --engine=tree and is ignored\n";
+  }
+#if !(defined(__x86_64__) && defined(__linux__))
+  if (options.jit_) {
+    std::cerr << "--jit is only supported on x86-64 Linux and is ignored\n";
+  }
+#endif
+}
+
+void RuntimeError(const std::string &message) {
+  output.Flush();
+  std::cerr << message << "\n";
+  std::exit(1);
+}
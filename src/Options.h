@@ -0,0 +1,53 @@
+#pragma once
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum ENGINE {kTREEENGINE, kVMENGINE, kCLOSUREENGINE};
+
+// Interpreter-wide settings, filled from the command line in main
+struct Options {
+  // Largest string a single operation may build (--max-str-bytes=N)
+  size_t max_str_bytes_ = size_t(1) << 30;
+  // str() and f-strings show floats in shortest repr form (--float-repr)
+  bool float_repr_ = false;
+  // Walk the lowered tree, compile it to bytecode for the VM, or compile it
+  // to closures (--engine=tree|vm|closure)
+  ENGINE engine_ = kTREEENGINE;
+  // Compile hot int/float while loops to x86-64 on the tree engine (--jit);
+  // ignored, with a warning, on the other engines and on other targets
+  bool jit_ = false;
+  // List every constant fold and pruned branch on stderr (--dump-folds)
+  bool dump_folds_ = false;
+  // Deepest nesting of user function calls before a RecursionError
+  // (--recursion-limit=N); 0 leaves it to the engine. Only --engine=vm
+  // supports large limits: the tree and closure engines recurse on the
+  // native stack and raise the RecursionError early when it runs low
+  size_t recursion_limit_ = 0;
+  // List each quickened node of the tree engine, with its specialization
+  // and deopt counts, on stderr at exit (--quicken-stats)
+  bool quicken_stats_ = false;
+  // User functions whose results are cached when they are pure
+  // (--memo=f,g, plus every def after a `# @memo` line)
+  std::vector<std::string> memo_{};
+  // Most cached calls kept per function; later calls simply run
+  // (--memo-size=N)
+  size_t memo_size_ = size_t(1) << 20;
+  // Hit and miss counts of each memoized function on stderr at exit
+  // (--memo-stats)
+  bool memo_stats_ = false;
+};
+
+extern Options options;
+
+// Parse --name=value flags; unknown flags are reported and ignored.
+// --flush=line|block|exit sets the policy of the print output sink.
+void ParseOptions(int argc, const char *argv[]);
+
+// Report a Python-level error (e.g. "MemoryError: ...") and stop
+[[noreturn]] void RuntimeError(const std::string &);
+
+#endif // OPTIONS_H
@@ -0,0 +1,49 @@
+#include "Output.h"
+#include "FloatFormat.h"
+#include <cerrno>
+#include <string>
+#include <unistd.h>
+
+OutputSink output(STDOUT_FILENO);
+
+OutputSink::OutputSink(int fd) : fd_(fd) {
+  buffer_.reserve(kBlockSize * 2);
+}
+
+OutputSink::~OutputSink() {
+  Flush();
+}
+
+void OutputSink::WriteInt(long long x) {
+  char buf[24];
+  char *end = buf + sizeof(buf), *p = end;
+  unsigned long long magnitude = x < 0 ? 0ULL - static_cast<unsigned long long>(x) : x;
+  do {
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (x < 0) {
+    *--p = '-';
+  }
+  buffer_.append(p, end);
+}
+
+void OutputSink::WriteFloat(double x) {
+  char buf[kFloatBufSize];
+  buffer_.append(buf, FormatFixed(x, buf));
+}
+
+void OutputSink::Flush() {
+  size_t done = 0;
+  while (done < buffer_.size()) {
+    ssize_t n = ::write(fd_, buffer_.data() + done, buffer_.size() - done);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    done += n;
+  }
+  buffer_.clear();
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <string>
+
+enum FLUSHPOLICY {kFLUSHLINE, kFLUSHBLOCK, kFLUSHEXIT};
+
+// Buffered stdout for print(): bytes are collected in user space and handed
+// to write(2) according to the flush policy, bypassing iostream entirely.
+class OutputSink {
+private:
+  std::string buffer_;
+  FLUSHPOLICY policy_ = kFLUSHBLOCK;
+  int fd_;
+
+  static constexpr size_t kBlockSize = 1 << 16;
+
+public:
+  explicit OutputSink(int fd);
+  ~OutputSink();
+
+  void SetPolicy(FLUSHPOLICY policy) {
+    policy_ = policy;
+  }
+
+  void Put(char ch) {
+    buffer_ += ch;
+  }
+  void Write(const char *data, size_t size) {
+    buffer_.append(data, size);
+  }
+  void Write(const std::string &s) {
+    buffer_ += s;
+  }
+  void WriteInt(long long);
+  // Fixed notation with six decimals, as print shows floats
+  void WriteFloat(double);
+
+  // Called after each print; flushes as the policy requires
+  void EndLine() {
+    if (policy_ == kFLUSHLINE || (policy_ == kFLUSHBLOCK && buffer_.size() >= kBlockSize)) {
+      Flush();
+    }
+  }
+  void Flush();
+};
+
+extern OutputSink output;
+
+#endif // OUTPUT_H
@@ -0,0 +1,53 @@
+#include "Resolve.h"
+#include <unordered_map>
+
+namespace {
+
+class Resolver {
+private:
+  Program &program_;
+  // nullptr for the module body
+  FuncInfo *info_;
+  std::unordered_map<uint32_t, uint32_t> slots_{};
+
+  uint32_t Slot(uint32_t name) {
+    auto it = slots_.find(name);
+    if (it != slots_.end()) {
+      return it->second;
+    }
+    info_->locals_.push_back(name);
+    return slots_[name] = info_->locals_.size() - 1;
+  }
+
+public:
+  Resolver(Program &program, FuncInfo *info) : program_(program), info_(info) {
+    if (info_ != nullptr) {
+      info_->locals_.clear();
+      for (auto param : info_->params_) {
+        Slot(param);
+      }
+    }
+  }
+  // Defaults of a nested def are children too: they run in this frame
+  void Walk(Node *node) {
+    if (info_ != nullptr && (node->kind_ == kNAME || node->kind_ == kAUGASSIGN)) {
+      node->slot_ = Slot(node->index_);
+    } else if (node->kind_ == kCALL) {
+      program_.calls_.push_back(node->index_);
+      node->slot_ = program_.calls_.size() - 1;
+    }
+    for (uint32_t i = 0; i < node->size_; i++) {
+      Walk(node->child_[i]);
+    }
+  }
+};
+
+} // namespace
+
+void Resolve(Program &program) {
+  program.calls_.clear();
+  for (auto &func : program.funcs_) {
+    Resolver(program, &func).Walk(func.body_);
+  }
+  Resolver(program, nullptr).Walk(program.body_);
+}
@@ -0,0 +1,14 @@
+#pragma once
+#ifndef RESOLVE_H
+#define RESOLVE_H
+
+#include "Ast.h"
+
+// Give every function a fixed frame layout: its parameters take the first
+// slots and each other name its body mentions the next free one. kNAME and
+// kAUGASSIGN nodes inside a function record their slot; names at module
+// level stay kNOSLOT and go straight to the global table. Every kCALL is
+// numbered as a call site so engines can keep a cache per site.
+void Resolve(Program &);
+
+#endif // RESOLVE_H
@@ -1,29 +1,20 @@
 #include "Scope.h"
+#include <utility>
 
-void Scope::VarRegister(const std::string &varname, std::any vardata) {
-  varmap_.back()[varname] = vardata;
-}
-
-std::any Scope::VarQuery(const std::string varname) {
-  if (varmap_.back().find(varname) != varmap_.back().end()) {
-    return varmap_.back()[varname];
+void Scope::VarSet(uint32_t name, uint32_t slot, Value vardata) {
+  if (auto local = Local(slot)) {
+    local->val_ = std::move(vardata);
+  } else if (globals_[name].bound_ || slot == kNOSLOT) {
+    globals_[name] = Slot{std::move(vardata), true};
   } else {
-    return varmap_[0][varname];
+    locals_[base_ + slot] = Slot{std::move(vardata), true};
   }
 }
 
-void Scope::VarSet(const std::string &varname, std::any vardata) {
-  if (!varmap_.back().empty() &&
-      varmap_.back().find(varname) != varmap_.back().end()) {
-    varmap_.back()[varname] = vardata;
-  } else if (varmap_[0].find(varname) != varmap_[0].end()){
-    varmap_[0][varname] = vardata;
-  } else {
-    varmap_.back()[varname] = vardata;
+Value &Scope::VarSlot(uint32_t name, uint32_t slot) {
+  if (auto local = Local(slot)) {
+    return local->val_;
   }
+  globals_[name].bound_ = true;
+  return globals_[name].val_;
 }
-
-bool Scope::VarFind(const std::string &varname) {
-  return (varmap_.back().find(varname) != varmap_.back().end()) ||
-         (varmap_[0].find(varname) != varmap_[0].end());
-}
\ No newline at end of file
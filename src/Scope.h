@@ -2,32 +2,69 @@
 #ifndef SCPOE_H
 #define SCPOE_H
 
+#include "Ast.h"
+#include "Value.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <any>
-#include <string>
-#include <unordered_map>
 
+// Variables by slot. Globals are a table indexed by Program name index; the
+// locals of each active call are a frame laid out by FuncInfo::locals_, and
+// all frames share one array. A slot counts only once it is bound, so a
+// function reads and writes the global of a name until it binds a local of
+// that name, and unbound names read as None.
 class Scope {
 private:
-  std::vector<std::unordered_map<std::string, std::any>> varmap_{};
+  struct Slot {
+    Value val_;
+    bool bound_ = false;
+  };
+  std::vector<Slot> globals_;
+  std::vector<Slot> locals_{};
+  // Base of each caller's frame; the running one starts at base_
+  std::vector<size_t> bases_{};
+  size_t base_ = 0;
+
+  Slot *Local(uint32_t slot) {
+    if (slot == kNOSLOT || !locals_[base_ + slot].bound_) {
+      return nullptr;
+    }
+    return &locals_[base_ + slot];
+  }
 
 public:
-  Scope() {
-    varmap_.emplace_back();
+  explicit Scope(size_t nnames) : globals_(nnames) {}
+
+  // Bind a parameter slot of the running call
+  void VarRegister(uint32_t slot, Value vardata) {
+    locals_[base_ + slot] = Slot{std::move(vardata), true};
   }
+  bool IsRegistered(uint32_t slot) const {
+    return locals_[base_ + slot].bound_;
+  }
+  const Value &VarQuery(uint32_t name, uint32_t slot) {
+    auto local = Local(slot);
+    return local != nullptr ? local->val_ : globals_[name].val_;
+  }
+  void VarSet(uint32_t name, uint32_t slot, Value vardata);
+  // The stored value VarQuery would read and VarSet would write, resolved
+  // once so augmented assignment can update it in place
+  Value &VarSlot(uint32_t name, uint32_t slot);
 
-  void VarRegister(const std::string &varname, std::any vardata) ;
-  std::any VarQuery(const std::string varname) ;
-  void VarSet(const std::string &varname, std::any vardata) ;
-  
-  bool VarFind(const std::string &varname) ;
+  bool VarFind(uint32_t name, uint32_t slot) {
+    return Local(slot) != nullptr || globals_[name].bound_;
+  }
 
-  void LayerCreate() {
-    varmap_.emplace_back();
+  void LayerCreate(size_t nslots) {
+    bases_.push_back(base_);
+    base_ = locals_.size();
+    locals_.resize(base_ + nslots);
   }
   void LayerDelete() {
-    varmap_.pop_back();
+    locals_.resize(base_);
+    base_ = bases_.back();
+    bases_.pop_back();
   }
 };
 
-#endif //SCOPE_H
\ No newline at end of file
+#endif //SCOPE_H
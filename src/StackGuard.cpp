@@ -0,0 +1,22 @@
+#include "StackGuard.h"
+#include <sys/resource.h>
+
+namespace {
+
+// Left free below the budget for whatever runs after the last check
+constexpr size_t kMargin = size_t(256) << 10;
+// Assumed when the rlimit is unlimited or unknown
+constexpr size_t kFallback = size_t(8) << 20;
+
+} // namespace
+
+void StackGuard::Enter() {
+  char here;
+  base_ = reinterpret_cast<uintptr_t>(&here);
+  size_t size = kFallback;
+  rlimit limit;
+  if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+    size = limit.rlim_cur;
+  }
+  budget_ = size > 2 * kMargin ? size - kMargin : size / 2;
+}
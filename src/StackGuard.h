@@ -0,0 +1,28 @@
+#pragma once
+#ifndef STACKGUARD_H
+#define STACKGUARD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Native stack headroom for the engines whose Python calls recurse in C++
+// (tree and closure). A raised --recursion-limit can outrun the native
+// stack there; checking this on every call turns that into the same clean
+// RecursionError instead of a segfault.
+class StackGuard {
+private:
+  uintptr_t base_ = 0;
+  size_t budget_ = 0;
+
+public:
+  // Start measuring from the caller's frame. The budget is the stack
+  // rlimit less a margin for builtins and error reporting.
+  void Enter();
+
+  bool Exhausted() const {
+    char here;
+    return base_ - reinterpret_cast<uintptr_t>(&here) > budget_;
+  }
+};
+
+#endif // STACKGUARD_H
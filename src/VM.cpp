@@ -0,0 +1,219 @@
+#include "VM.h"
+#include "InnerFunc.h"
+#include "operator.h"
+#include "Options.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+VM::VM(const Program &program) : program_(program), scope_(program.names_.size()), memo_(program) {
+  Compile(program_, module_);
+  for (const auto &site : module_.calls_) {
+    caches_.emplace_back(program_.names_[site.name_]);
+  }
+  stack_.reserve(1024);
+}
+
+void VM::Run() {
+  Execute(module_.codes_.back());
+  if (options.memo_stats_) {
+    memo_.Dump();
+  }
+}
+
+Value VM::Execute(const Code &entry) {
+  size_t limit = options.recursion_limit_ != 0 ? options.recursion_limit_ : kDefaultRecursionLimit;
+  const Code *code = &entry;
+  size_t base = stack_.size();
+  stack_.resize(base + code->nregs_);
+  Value *regs = stack_.data() + base;
+  const Value *consts = module_.consts_.data();
+  const Instr *begin = code->instrs_.data(), *pc = begin;
+  while (true) {
+    const Instr &instr = *pc++;
+    switch (instr.op_) {
+      case kOPLOADK:
+        regs[instr.a_] = consts[instr.b_];
+        break;
+      case kOPLOADNAME: {
+        // Unbound names read as None
+        regs[instr.a_] = scope_.VarQuery(instr.b_, instr.c_);
+        break;
+      }
+      case kOPSTORENAME:
+        scope_.VarSet(instr.a_, instr.c_, regs[instr.b_]);
+        break;
+      case kOPAUGNAME:
+        AugmentOp(instr.kind_, scope_.VarSlot(instr.a_, instr.c_), regs[instr.b_]);
+        break;
+      case kOPMOVE:
+        regs[instr.a_] = regs[instr.b_];
+        break;
+      case kOPBINARY:
+        regs[instr.a_] = BinaryOp(instr.kind_, regs[instr.b_], regs[instr.c_]);
+        break;
+      case kOPCOMPARE:
+        regs[instr.a_] = Value(CompareOp(instr.kind_, regs[instr.b_], regs[instr.c_]));
+        break;
+      case kOPNEG:
+        regs[instr.a_] = -regs[instr.b_];
+        break;
+      case kOPNOT:
+        regs[instr.a_] = Value(!GetBool(regs[instr.b_]));
+        break;
+      case kOPJUMP:
+        pc = begin + instr.a_;
+        break;
+      case kOPJUMPIFNOT:
+        if (!GetBool(regs[instr.a_])) {
+          pc = begin + instr.b_;
+        }
+        break;
+      case kOPJUMPIF:
+        if (GetBool(regs[instr.a_])) {
+          pc = begin + instr.b_;
+        }
+        break;
+      case kOPCALL: {
+        Value res;
+        Memo::Entry *memo = nullptr;
+        const Code *callee = Call(instr.b_, base + instr.c_, res, memo);
+        if (callee == nullptr) {
+          regs[instr.a_] = std::move(res);
+          break;
+        }
+        // Suspend this frame and continue in the callee, on the same loop
+        if (frames_.size() >= limit) {
+          RuntimeError("RecursionError: maximum recursion depth exceeded");
+        }
+        frames_.push_back(Frame{code, pc, base, instr.a_, memo});
+        code = callee;
+        base = stack_.size();
+        stack_.resize(base + code->nregs_);
+        regs = stack_.data() + base;
+        begin = pc = code->instrs_.data();
+        break;
+      }
+      case kOPFSTRING: {
+        std::string res;
+        for (uint32_t i = 0; i < instr.c_; i++) {
+          res += *BorrowString(regs[instr.b_ + i]);
+        }
+        regs[instr.a_] = Value(res);
+        break;
+      }
+      case kOPUNPACK:
+        Unpack(module_.assigns_[instr.a_], regs + instr.b_);
+        break;
+      case kOPDEF: {
+        // Defaults are evaluated once, when the def runs
+        const auto &info = program_.funcs_[instr.a_];
+        size_t nodefault = info.params_.size() - instr.c_;
+        std::vector<Value> initial;
+        for (size_t i = 0; i < info.params_.size(); i++) {
+          initial.push_back(i < nodefault ? Value() : regs[instr.b_ + i - nodefault]);
+        }
+        func_.AddFunc(program_.names_[info.name_], std::move(initial), instr.a_);
+        break;
+      }
+      case kOPRETURN:
+      case kOPRETURNTUPLE:
+      case kOPRETURNNONE: {
+        Value res;
+        if (instr.op_ == kOPRETURN) {
+          res = std::move(regs[instr.a_]);
+        } else if (instr.op_ == kOPRETURNTUPLE) {
+          res = Value(std::vector<Value>(regs + instr.a_, regs + instr.a_ + instr.b_));
+        }
+        stack_.resize(base);
+        if (frames_.empty()) {
+          return res;
+        }
+        scope_.LayerDelete();
+        const auto &caller = frames_.back();
+        code = caller.code_;
+        base = caller.base_;
+        regs = stack_.data() + base;
+        begin = code->instrs_.data();
+        pc = caller.pc_;
+        if (caller.memo_ != nullptr) {
+          caller.memo_->result_ = res;
+          caller.memo_->ready_ = true;
+        }
+        regs[caller.result_] = std::move(res);
+        frames_.pop_back();
+        break;
+      }
+    }
+  }
+}
+
+const Code *VM::Call(uint32_t index, size_t args, Value &res, Memo::Entry *&memo) {
+  const auto &site = module_.calls_[index];
+  const auto &funcname = program_.names_[site.name_];
+  std::vector<Value> position;
+  std::vector<std::pair<uint32_t, Value>> keyboard;
+  for (uint32_t i = 0; i < site.npos_; i++) {
+    auto &val = stack_[args + i];
+    if (val.IsTuple()) {
+      for (const auto &q : val.Tuple()) {
+        position.push_back(q);
+      }
+    } else {
+      position.push_back(std::move(val));
+    }
+  }
+  for (size_t i = 0; i < site.keywords_.size(); i++) {
+    keyboard.emplace_back(site.keywords_[i], std::move(stack_[args + site.npos_ + i]));
+  }
+  auto &cache = caches_[index];
+  if (cache.inner_ != kNOTINNER) {
+    for (auto &x : keyboard) {
+      position.push_back(std::move(x.second));
+    }
+    res = Inner(cache.inner_, position);
+    return nullptr;
+  }
+
+  auto def = cache.Resolve(func_, funcname);
+  if (def == nullptr) {
+    RuntimeError("NameError: name '" + funcname + "' is not defined");
+  }
+  const auto &info = program_.funcs_[def->index_];
+  scope_.LayerCreate(info.locals_.size());
+  func_.BindArgs(scope_, *def, info, position, keyboard);
+  memo = memo_.Find(def->index_, scope_);
+  if (memo != nullptr && memo->ready_) {
+    scope_.LayerDelete();
+    res = memo->result_;
+    return nullptr;
+  }
+  return &module_.codes_[def->index_];
+}
+
+void VM::Unpack(const AssignSite &site, const Value *regs) {
+  std::vector<Value> values;
+  for (uint32_t i = 0; i < site.nvalues_; i++) {
+    if (regs[i].IsTuple()) {
+      for (const auto &q : regs[i].Tuple()) {
+        values.push_back(q);
+      }
+    } else {
+      values.push_back(regs[i]);
+    }
+  }
+  for (const auto &targets : site.rows_) {
+    if (targets.size() == 1 && values.size() != 1) {
+      // a = 1, 2 binds the whole tuple
+      scope_.VarSet(targets[0].name_, targets[0].slot_, Value(std::vector<Value>(values)));
+      continue;
+    }
+    if (targets.size() != values.size()) {
+      RuntimeError("ValueError: expected " + std::to_string(targets.size()) + " values to unpack, got " +
+                   std::to_string(values.size()));
+    }
+    for (size_t j = 0; j < targets.size(); j++) {
+      scope_.VarSet(targets[j].name_, targets[j].slot_, values[j]);
+    }
+  }
+}
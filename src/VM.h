@@ -0,0 +1,62 @@
+#pragma once
+#ifndef VM_H
+#define VM_H
+
+#include "Ast.h"
+#include "Bytecode.h"
+#include "Func.h"
+#include "Memo.h"
+#include "Scope.h"
+#include "Value.h"
+#include <cstddef>
+#include <vector>
+
+// Runs the register bytecode of a compiled Program (--engine=vm). Frames
+// are windows onto one growing register stack; variables still live in
+// the Scope, so both engines bind names identically. A call does not
+// recurse in C++: the caller is suspended on frames_ and the same dispatch
+// loop runs the callee, so recursion depth is bounded only by the heap and
+// --recursion-limit.
+//
+// Known limitation: a call still packs its arguments into vectors and binds
+// them through a Scope layer, as the tree engine does, so call-bound code
+// such as recursive fib runs no faster than on the tree engine. The VM pays
+// off in loops and expressions.
+class VM {
+private:
+  // A caller waiting at a kOPCALL for the result to land in register result_
+  struct Frame {
+    const Code *code_;
+    const Instr *pc_;
+    size_t base_;
+    uint32_t result_;
+    // Memo entry the callee's result fills, if it is cached
+    Memo::Entry *memo_;
+  };
+  static constexpr size_t kDefaultRecursionLimit = 1000000;
+
+  const Program &program_;
+  Module module_{};
+  Scope scope_;
+  Function func_{};
+  std::vector<Value> stack_{};
+  // Inline cache of each entry of module_.calls_
+  std::vector<CallCache> caches_{};
+  std::vector<Frame> frames_{};
+  Memo memo_;
+
+  Value Execute(const Code &);
+  // Call through module_.calls_[site] with its arguments at stack_[args], ...
+  // A builtin runs at once, leaving its result in `res`, and gives nullptr;
+  // for a user function the callee's scope layer is entered and its code
+  // returned for the dispatch loop to run, with `memo` set to the entry its
+  // result fills. A memoized call that hits is answered like a builtin.
+  const Code *Call(uint32_t site, size_t args, Value &res, Memo::Entry *&memo);
+  void Unpack(const AssignSite &, const Value *values);
+
+public:
+  explicit VM(const Program &);
+  void Run();
+};
+
+#endif // VM_H
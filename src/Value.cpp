@@ -0,0 +1,175 @@
+#include "Value.h"
+
+Value::Value(const sjtu::int2048 &x) : type_(kINT), int_(0) {
+  if (!x.to_long_long(int_)) {
+    type_ = kBIGINT;
+    bigint_ = new Boxed<sjtu::int2048>(x);
+  }
+}
+
+Value::Value(std::string s) : type_(kSTR) {
+  str_ = new StrBox(std::move(s));
+}
+
+Value::Value(std::vector<Value> array) : type_(kTUPLE) {
+  tuple_ = new Boxed<std::vector<Value>>(std::move(array));
+}
+
+StrBox::StrBox(StrBox *left, StrBox *right)
+    : size_(left->Size() + right->Size()), left_(left), right_(right) {
+  left->refcount_++;
+  right->refcount_++;
+}
+
+// Concatenations shorter than this are copied right away
+constexpr size_t kRopeThreshold = 256;
+
+Value Value::Concat(const Value &a, const Value &b) {
+  if (a.StrSize() + b.StrSize() < kRopeThreshold) {
+    return a.Str() + b.Str();
+  }
+  Value res;
+  res.type_ = kSTR;
+  res.str_ = new StrBox(a.str_, b.str_);
+  return res;
+}
+
+void Value::Flatten(StrBox *box) {
+  // The leftmost leaf buffer is reused when nothing else can reach it,
+  // which makes a read after each append amortized O(piece)
+  std::string out;
+  StrBox *stolen = nullptr;
+  for (StrBox *p = box->left_; p->refcount_ == 1; p = p->left_) {
+    if (p->left_ == nullptr) {
+      stolen = p;
+      out = std::move(p->flat_);
+      break;
+    }
+  }
+  out.reserve(box->size_);
+
+  // In-order walk over the leaves with an explicit stack, since appending
+  // in a loop builds chains far deeper than the native stack
+  std::vector<const StrBox *> stack{box->right_, box->left_};
+  while (!stack.empty()) {
+    const StrBox *p = stack.back();
+    stack.pop_back();
+    if (p->left_ != nullptr) {
+      stack.push_back(p->right_);
+      stack.push_back(p->left_);
+    } else if (p != stolen) {
+      out += p->flat_;
+    }
+  }
+
+  ReleaseStr(box->left_);
+  ReleaseStr(box->right_);
+  box->left_ = box->right_ = nullptr;
+  box->flat_ = std::move(out);
+}
+
+void Value::ReleaseStr(StrBox *box) {
+  // Iterative, for the same reason as Flatten
+  std::vector<StrBox *> dead;
+  if (--box->refcount_ == 0) {
+    dead.push_back(box);
+  }
+  while (!dead.empty()) {
+    StrBox *p = dead.back();
+    dead.pop_back();
+    if (p->left_ != nullptr) {
+      if (--p->left_->refcount_ == 0) {
+        dead.push_back(p->left_);
+      }
+      if (--p->right_->refcount_ == 0) {
+        dead.push_back(p->right_);
+      }
+    }
+    delete p;
+  }
+}
+
+std::string &Value::MutableStr() {
+  if (str_->left_ != nullptr) {
+    Flatten(str_);
+  }
+  if (str_->refcount_ > 1) {
+    str_->refcount_--;
+    str_ = new StrBox(str_->flat_);
+  }
+  return str_->flat_;
+}
+
+sjtu::int2048 &Value::MutableBigInt() {
+  if (bigint_->refcount_ > 1) {
+    bigint_->refcount_--;
+    bigint_ = new Boxed<sjtu::int2048>(bigint_->val_);
+  }
+  return bigint_->val_;
+}
+
+void Value::ShrinkInt() {
+  long long x;
+  if (type_ == kBIGINT && bigint_->val_.to_long_long(x)) {
+    Release();
+    type_ = kINT;
+    int_ = x;
+  }
+}
+
+void Value::Retain() const {
+  switch (type_) {
+    case kBIGINT:
+      bigint_->refcount_++;
+      break;
+    case kSTR:
+      str_->refcount_++;
+      break;
+    case kTUPLE:
+      tuple_->refcount_++;
+      break;
+    default:
+      break;
+  }
+}
+
+void Value::Release() {
+  switch (type_) {
+    case kBIGINT:
+      if (--bigint_->refcount_ == 0) {
+        delete bigint_;
+      }
+      break;
+    case kSTR:
+      ReleaseStr(str_);
+      break;
+    case kTUPLE:
+      if (--tuple_->refcount_ == 0) {
+        delete tuple_;
+      }
+      break;
+    default:
+      break;
+  }
+  type_ = kNONE;
+}
+
+Value &Value::operator=(const Value &other) {
+  if (this != &other) {
+    other.Retain();
+    Release();
+    type_ = other.type_;
+    int_ = other.int_;
+  }
+  return *this;
+}
+
+Value &Value::operator=(Value &&other) noexcept {
+  if (this != &other) {
+    Release();
+    type_ = other.type_;
+    int_ = other.int_;
+    other.type_ = kNONE;
+  }
+  return *this;
+}
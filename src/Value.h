@@ -0,0 +1,151 @@
+#pragma once
+#ifndef VALUE_H
+#define VALUE_H
+
+#include "int2048.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// A refcounted heap payload shared by every Value that points to it
+template <class T>
+struct Boxed {
+  int refcount_;
+  T val_;
+
+  template <class... Args>
+  explicit Boxed(Args &&...args) : refcount_(1), val_(std::forward<Args>(args)...) {}
+};
+
+// String payload: either flat, or a pending concatenation left + right that
+// is flattened on first read. Repeated s = s + piece only links nodes, so
+// building a string piecewise stays linear.
+struct StrBox {
+  int refcount_ = 1;
+  // Total length while the concatenation is pending
+  size_t size_ = 0;
+  std::string flat_;
+  // Owned references, both set while the concatenation is pending
+  StrBox *left_ = nullptr;
+  StrBox *right_ = nullptr;
+
+  explicit StrBox(std::string s) : flat_(std::move(s)) {}
+  StrBox(StrBox *left, StrBox *right);
+
+  size_t Size() const {
+    return left_ != nullptr ? size_ : flat_.size();
+  }
+};
+
+// 16-byte tagged interpreter value.
+// None, bool, ints that fit in 64 bits and floats are stored inline;
+// big ints, strings and tuples live in refcounted boxes.
+class Value {
+public:
+  enum Type : unsigned char {kNONE, kBOOL, kINT, kBIGINT, kFLOAT, kSTR, kTUPLE};
+
+private:
+  Type type_ = kNONE;
+  union {
+    bool bool_;
+    long long int_;
+    double float_;
+    Boxed<sjtu::int2048> *bigint_;
+    StrBox *str_;
+    Boxed<std::vector<Value>> *tuple_;
+  };
+
+  void Retain() const;
+  void Release();
+  static void Flatten(StrBox *);
+  static void ReleaseStr(StrBox *);
+
+public:
+  Value() : int_(0) {}
+  Value(bool x) : type_(kBOOL), int_(0) {
+    bool_ = x;
+  }
+  Value(int x) : type_(kINT), int_(x) {}
+  Value(long long x) : type_(kINT), int_(x) {}
+  Value(double x) : type_(kFLOAT), float_(x) {}
+  // Demoted to an inline int when it fits in 64 bits
+  Value(const sjtu::int2048 &);
+  Value(std::string);
+  Value(const char *s) : Value(std::string(s)) {}
+  Value(std::vector<Value>);
+
+  Value(const Value &other) : type_(other.type_), int_(other.int_) {
+    Retain();
+  }
+  Value(Value &&other) noexcept : type_(other.type_), int_(other.int_) {
+    other.type_ = kNONE;
+  }
+  Value &operator=(const Value &);
+  Value &operator=(Value &&) noexcept;
+  ~Value() {
+    Release();
+  }
+
+  Type GetType() const {
+    return type_;
+  }
+  bool IsNone() const {
+    return type_ == kNONE;
+  }
+  bool IsBool() const {
+    return type_ == kBOOL;
+  }
+  // Small or big int
+  bool IsInt() const {
+    return type_ == kINT || type_ == kBIGINT;
+  }
+  bool IsFloat() const {
+    return type_ == kFLOAT;
+  }
+  bool IsStr() const {
+    return type_ == kSTR;
+  }
+  bool IsTuple() const {
+    return type_ == kTUPLE;
+  }
+
+  // Unchecked payload access, valid only for the matching type
+  bool Bool() const {
+    return bool_;
+  }
+  long long SmallInt() const {
+    return int_;
+  }
+  double Float() const {
+    return float_;
+  }
+  const sjtu::int2048 &BigInt() const {
+    return bigint_->val_;
+  }
+  const std::string &Str() const {
+    if (str_->left_ != nullptr) {
+      Flatten(str_);
+    }
+    return str_->flat_;
+  }
+  // Length of a string without flattening it
+  size_t StrSize() const {
+    return str_->Size();
+  }
+  // a + b for two strings; long results are linked rather than copied
+  static Value Concat(const Value &, const Value &);
+  const std::vector<Value> &Tuple() const {
+    return tuple_->val_;
+  }
+
+  // Copy-on-write access for in-place updates: a box shared with other
+  // Values is cloned first, so the mutation is never observed elsewhere
+  std::string &MutableStr();
+  sjtu::int2048 &MutableBigInt();
+  // Restore the inline representation after a big int was mutated in place
+  void ShrinkInt();
+};
+
+static_assert(sizeof(Value) == 16, "Value must stay two words wide");
+
+#endif // VALUE_H
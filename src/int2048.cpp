@@ -1,8 +1,16 @@
 #include "int2048.h"
 #include <string>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace sjtu {
 
+namespace radix {
+template <class Policy = limb_policy>
+void append_decimal(std::string &, const limb_view &);
+}  // namespace radix
+
 // ============================================================================
 // Constructors and Destructor
 // ============================================================================
@@ -11,22 +19,23 @@ int2048::int2048() : vals_(1, 0), sign_bit_(1) {}
 
 int2048::int2048(long long x) {
     if (x == 0) {
-        vals_ = std::vector<int>(1, 0);
+        vals_ = std::vector<limb_t>(1, 0);
         sign_bit_ = 1;
         return;
     }
-    
-    vals_.clear();
+
     sign_bit_ = (x > 0) ? 1 : -1;
+    // Negate in unsigned arithmetic so that LLONG_MIN is handled too
+    unsigned long long magnitude = static_cast<unsigned long long>(x);
     if (x < 0) {
-        x = -x;
+        magnitude = 0ULL - magnitude;
     }
-    
+
     // Reserve space for efficiency
-    vals_.reserve(static_cast<int>(std::log10(x) / kLEN) + 1);
-    while (x > 0) {
-        vals_.emplace_back(x % kBASE);
-        x /= kBASE;
+    vals_.reserve(64 / kLEN + 1);
+    while (magnitude > 0) {
+        vals_.emplace_back(static_cast<limb_t>(magnitude % kBASE));
+        magnitude /= kBASE;
     }
 }
 
@@ -40,6 +49,16 @@ int2048::int2048(const poly &a) {
     *this = to_int2048(a);
 }
 
+int2048::int2048(const limb_view &v) : sign_bit_(1) {
+    if (v.size == 0) {
+        vals_.assign(1, 0);
+        return;
+    }
+    vals_.reserve(v.len());
+    vals_.assign(v.shift, 0);
+    vals_.insert(vals_.end(), v.data, v.data + v.size);
+}
+
 int2048::~int2048() {
     vals_.clear();
     vals_.shrink_to_fit();
@@ -52,12 +71,33 @@ int2048::~int2048() {
 int2048::operator double() const {
     double result = 0.0;
     for (int i = len() - 1; i >= 0; --i) {
-        result *= kBASE;
+        result *= static_cast<double>(kBASE);
         result += vals_[i];
     }
     return result * sign_bit_;
 }
 
+bool int2048::to_long_long(long long &out) const {
+    constexpr unsigned __int128 kLimit = static_cast<unsigned __int128>(1) << 63;
+    unsigned __int128 magnitude = 0;
+    for (int i = len() - 1; i >= 0; --i) {
+        magnitude = magnitude * kBASE + vals_[i];
+        if (magnitude > kLimit) {
+            return false;
+        }
+    }
+    if (sign_bit_ == 1) {
+        if (magnitude == kLimit) {
+            return false;
+        }
+        out = static_cast<long long>(magnitude);
+    } else {
+        // -2^63 is representable, so negate in unsigned arithmetic
+        out = static_cast<long long>(0ULL - static_cast<unsigned long long>(magnitude));
+    }
+    return true;
+}
+
 int2048::operator std::string() const {
     // Handle zero case
     if (*this == int2048(0)) {
@@ -68,16 +108,8 @@ int2048::operator std::string() const {
     if (sign_bit_ == -1) {
         s = "-";
     }
-    
-    // Add the most significant digit without leading zeros
-    s += std::to_string(vals_.back());
-    
-    // Add remaining digits with leading zeros
-    for (int i = len() - 2; i >= 0; --i) {
-        std::string digit = std::to_string(vals_[i]);
-        s += std::string(kLEN - digit.size(), '0') + digit;
-    }
-    
+    radix::append_decimal(s, view());
+
     return s;
 }
 
@@ -85,9 +117,222 @@ int2048::operator std::string() const {
 // Input/Output Functions
 // ============================================================================
 
+namespace radix {
+
+/**
+ * Value of a run of decimal digits (at most kLEN of them)
+ */
+limb_t parse_chunk(const char *s, int n) {
+    limb_t chunk = 0;
+    for (int i = 0; i < n; ++i) {
+        chunk = chunk * 10 + static_cast<limb_t>(s[i] - '0');
+    }
+    return chunk;
+}
+
+/**
+ * Append the decimal digits of a value below 10^kLEN
+ * @param pad Zero-pad to exactly kLEN digits
+ */
+void append_chunk(std::string &s, limb_t x, bool pad) {
+    char buf[kLEN];
+    int pos = kLEN;
+    do {
+        buf[--pos] = static_cast<char>('0' + x % 10);
+        x /= 10;
+    } while (x > 0 || (pad && pos > 0));
+    s.append(buf + pos, buf + kLEN);
+}
+
+/**
+ * Multiply limbs by a single limb and add another, in place
+ * @return Carry out of the top limb
+ */
+limb_t mul_add_1(limb_t *v, int n, limb_t mult, limb_t add) {
+    limb_policy::wide_t carry = add;
+    for (int i = 0; i < n; ++i) {
+        carry += static_cast<limb_policy::wide_t>(v[i]) * mult;
+        v[i] = static_cast<limb_t>(carry % kBASE);
+        carry /= kBASE;
+    }
+    return static_cast<limb_t>(carry);
+}
+
+/**
+ * Divide limbs by a single limb in place
+ * @return Remainder
+ */
+limb_t divmod_1(limb_t *v, int n, limb_t d) {
+    limb_policy::wide_t rem = 0;
+    for (int i = n - 1; i >= 0; --i) {
+        rem = rem * kBASE + v[i];
+        v[i] = static_cast<limb_t>(rem / d);
+        rem %= d;
+    }
+    return static_cast<limb_t>(rem);
+}
+
+/**
+ * Append the decimal digits of a magnitude by repeated short division
+ * Quadratic; the base case of the divide-and-conquer conversion.
+ */
+void append_basecase(std::string &s, const limb_view &v) {
+    constexpr limb_t kChunk = static_cast<limb_t>(ipow10(kLEN));
+    std::vector<limb_t> rest(v.shift, 0), chunks;
+    rest.insert(rest.end(), v.data, v.data + v.size);
+    while (!rest.empty()) {
+        chunks.push_back(divmod_1(rest.data(), static_cast<int>(rest.size()), kChunk));
+        while (!rest.empty() && rest.back() == 0) {
+            rest.pop_back();
+        }
+    }
+    if (chunks.empty()) {
+        chunks.push_back(0);
+    }
+    append_chunk(s, chunks.back(), false);
+    for (int i = static_cast<int>(chunks.size()) - 2; i >= 0; --i) {
+        append_chunk(s, chunks[i], true);
+    }
+}
+
+/**
+ * Convert a run of decimal digits to limbs
+ */
+template <class Policy = limb_policy>
+std::vector<limb_t> parse_decimal(const char *s, int n) {
+    std::vector<limb_t> vals;
+    vals.reserve(n / kLEN + 1);
+
+    if constexpr (Policy::kDecimal) {
+        // Read digits from right to left in chunks of kLEN
+        for (int i = n; i > 0; i -= kLEN) {
+            int chunk_len = std::min(kLEN, i);
+            vals.push_back(parse_chunk(s + i - chunk_len, chunk_len));
+        }
+    } else {
+        // Horner's rule over chunks of kLEN digits, most significant first
+        int head = n % kLEN == 0 ? kLEN : n % kLEN;
+        vals.push_back(parse_chunk(s, std::min(head, n)));
+        for (int i = head; i < n; i += kLEN) {
+            limb_t carry = mul_add_1(vals.data(), static_cast<int>(vals.size()),
+                                     static_cast<limb_t>(ipow10(kLEN)), parse_chunk(s + i, kLEN));
+            if (carry != 0) {
+                vals.push_back(carry);
+            }
+        }
+    }
+
+    // Remove leading zeros
+    while (vals.size() > 1 && vals.back() == 0) {
+        vals.pop_back();
+    }
+    if (vals.empty()) {
+        vals.push_back(0);
+    }
+    return vals;
+}
+
+// Binary magnitudes above this many limbs are converted by divide and conquer
+constexpr int kConvertLimit = 32;
+
+// powers[k] = 10^(kLEN * 2^k), squared on demand and kept for later conversions
+std::vector<int2048> powers;
+
+const int2048 &power(int k) {
+    while (static_cast<int>(powers.size()) <= k) {
+        if (powers.empty()) {
+            limb_t chunk = static_cast<limb_t>(ipow10(kLEN));
+            powers.emplace_back(limb_view{&chunk, 1, 0});
+        } else {
+            powers.push_back(powers.back() * powers.back());
+        }
+    }
+    return powers[k];
+}
+
+/**
+ * Divide-and-conquer binary to decimal conversion
+ * x < 10^(kLEN * 2^(k + 1)) is split at 10^(kLEN * 2^k) into a quotient and
+ * a remainder that are converted independently, so the cost is dominated
+ * by O(log n) divisions instead of n short divisions.
+ * @param pad Zero-pad to exactly kLEN * 2^(k + 1) digits
+ */
+void append_split(std::string &s, const int2048 &x, int k, bool pad) {
+    limb_view v = x.view();
+    if (k < 0 || v.size <= kConvertLimit) {
+        size_t start = s.size();
+        append_basecase(s, v);
+        if (pad) {
+            size_t width = static_cast<size_t>(kLEN) << (k + 1);
+            s.insert(start, width - (s.size() - start), '0');
+        }
+        return;
+    }
+
+    int2048 quotient = x / power(k);
+    int2048 remainder = x - quotient * power(k);
+    if (pad || quotient.view().size != 0) {
+        append_split(s, quotient, k - 1, pad);
+        append_split(s, remainder, k - 1, true);
+    } else {
+        append_split(s, remainder, k - 1, false);
+    }
+}
+
+/**
+ * Divide-and-conquer decimal to binary conversion
+ * The digits are split so that the low part has kLEN * 2^k of them and the
+ * halves are joined with one multiplication by a cached power.
+ */
+int2048 parse_split(const char *s, int n) {
+    if (n <= kLEN * kConvertLimit) {
+        auto vals = parse_decimal(s, n);
+        return int2048(limb_view{vals.data(), static_cast<int>(vals.size()), 0});
+    }
+
+    int k = 0;
+    while ((kLEN << (k + 1)) < n) {
+        k++;
+    }
+    int low = kLEN << k;
+    return parse_split(s, n - low) * power(k) + parse_split(s + n - low, low);
+}
+
+/**
+ * Append the decimal digits of a magnitude
+ * Decimal limbs are printed directly; binary limbs go through short
+ * division when small and divide and conquer otherwise.
+ */
+template <class Policy>
+void append_decimal(std::string &s, const limb_view &v) {
+    if (v.size == 0) {
+        s += '0';
+        return;
+    }
+
+    if constexpr (Policy::kDecimal) {
+        append_chunk(s, v.limb(v.len() - 1), false);
+        for (int i = v.len() - 2; i >= 0; --i) {
+            append_chunk(s, v.limb(i), true);
+        }
+    } else if (v.len() <= kConvertLimit) {
+        append_basecase(s, v);
+    } else {
+        // Pick k so that x < 10^(kLEN * 2^(k + 1)) from the bit length alone
+        long long digits = static_cast<long long>(v.len()) * Policy::kBits * 30103 / 100000 + 1;
+        int k = 0;
+        while ((static_cast<long long>(kLEN) << (k + 1)) < digits) {
+            k++;
+        }
+        append_split(s, int2048(v), k, false);
+    }
+}
+
+}  // namespace radix
+
 void int2048::read(const std::string &s) {
     int start_pos = 0;
-    
+
     // Handle sign
     if (!s.empty() && s[0] == '-') {
         sign_bit_ = -1;
@@ -95,23 +340,15 @@ void int2048::read(const std::string &s) {
     } else {
         sign_bit_ = 1;
     }
-    
-    vals_.clear();
-    vals_.reserve((s.size() - start_pos) / kLEN + 1);
-    
-    // Read digits from right to left in chunks of kLEN
-    for (int i = static_cast<int>(s.size()) - 1; i >= start_pos; i -= kLEN) {
-        int chunk = 0;
-        int chunk_len = std::min(kLEN, i + 1 - start_pos);
-        for (int j = chunk_len - 1; j >= 0; --j) {
-            chunk = chunk * 10 + (s[i - j] - '0');
-        }
-        vals_.emplace_back(chunk);
-    }
-    
-    // Remove leading zeros
-    while (vals_.size() > 1 && vals_.back() == 0) {
-        vals_.pop_back();
+
+    const char *digits = s.data() + start_pos;
+    int n = static_cast<int>(s.size()) - start_pos;
+    if constexpr (limb_policy::kDecimal) {
+        vals_ = radix::parse_decimal(digits, n);
+    } else {
+        int sign = sign_bit_;
+        *this = radix::parse_split(digits, n);
+        sign_bit_ = sign;
     }
 }
 
@@ -119,6 +356,129 @@ void int2048::print() {
     std::cout << (*this);
 }
 
+// ============================================================================
+// Carry-Chain Kernels
+// ============================================================================
+
+namespace kernel {
+
+using wide_t = limb_policy::wide_t;
+
+/**
+ * One step of an add-with-carry chain (adc)
+ * Binary limbs use the hardware carry flag; decimal limbs compare against kBASE.
+ */
+inline limb_t add_carry(limb_t x, limb_t y, unsigned char &carry) {
+    if constexpr (limb_policy::kDecimal) {
+        wide_t sum = static_cast<wide_t>(x) + y + carry;
+        carry = (sum >= kBASE);
+        return static_cast<limb_t>(carry ? sum - kBASE : sum);
+    } else {
+        limb_t sum;
+#if defined(__x86_64__)
+        if constexpr (sizeof(limb_t) == 8) {
+            unsigned long long out;
+            carry = _addcarry_u64(carry, x, y, &out);
+            sum = static_cast<limb_t>(out);
+        } else {
+            unsigned int out;
+            carry = _addcarry_u32(carry, static_cast<unsigned int>(x), static_cast<unsigned int>(y), &out);
+            sum = static_cast<limb_t>(out);
+        }
+#else
+        unsigned char c1 = __builtin_add_overflow(x, y, &sum);
+        unsigned char c2 = __builtin_add_overflow(sum, static_cast<limb_t>(carry), &sum);
+        carry = c1 | c2;
+#endif
+        return sum;
+    }
+}
+
+/**
+ * One step of a subtract-with-borrow chain (sbb)
+ */
+inline limb_t sub_borrow(limb_t x, limb_t y, unsigned char &borrow) {
+    if constexpr (limb_policy::kDecimal) {
+        wide_t sub = static_cast<wide_t>(y) + borrow;
+        borrow = (x < sub);
+        return static_cast<limb_t>(x + (borrow ? kBASE : 0) - sub);
+    } else {
+        limb_t diff;
+#if defined(__x86_64__)
+        if constexpr (sizeof(limb_t) == 8) {
+            unsigned long long out;
+            borrow = _subborrow_u64(borrow, x, y, &out);
+            diff = static_cast<limb_t>(out);
+        } else {
+            unsigned int out;
+            borrow = _subborrow_u32(borrow, static_cast<unsigned int>(x), static_cast<unsigned int>(y), &out);
+            diff = static_cast<limb_t>(out);
+        }
+#else
+        unsigned char b1 = __builtin_sub_overflow(x, y, &diff);
+        unsigned char b2 = __builtin_sub_overflow(diff, static_cast<limb_t>(borrow), &diff);
+        borrow = b1 | b2;
+#endif
+        return diff;
+    }
+}
+
+/**
+ * r = a + b, where a has an limbs and b has bn <= an limbs
+ * r may alias a; the chain stops as soon as the carry dies out.
+ * @return Carry out of the top limb
+ */
+limb_t add(limb_t *r, const limb_t *a, int an, const limb_t *b, int bn) {
+    unsigned char carry = 0;
+    int i = 0;
+    for (; i < bn; ++i) {
+        r[i] = add_carry(a[i], b[i], carry);
+    }
+    for (; i < an && carry; ++i) {
+        r[i] = add_carry(a[i], 0, carry);
+    }
+    if (r != a) {
+        std::copy(a + i, a + an, r + i);
+    }
+    return carry;
+}
+
+/**
+ * r = a - b, where a has an limbs and b has bn <= an limbs
+ * r may alias a; the chain stops as soon as the borrow dies out.
+ * @return Borrow out of the top limb
+ */
+limb_t sub(limb_t *r, const limb_t *a, int an, const limb_t *b, int bn) {
+    unsigned char borrow = 0;
+    int i = 0;
+    for (; i < bn; ++i) {
+        r[i] = sub_borrow(a[i], b[i], borrow);
+    }
+    for (; i < an && borrow; ++i) {
+        r[i] = sub_borrow(a[i], 0, borrow);
+    }
+    if (r != a) {
+        std::copy(a + i, a + an, r + i);
+    }
+    return borrow;
+}
+
+/**
+ * r += a * b over n limbs, one widening multiply (mul/mulx) per limb
+ * @return Carry out of the top limb
+ */
+limb_t addmul_1(limb_t *r, const limb_t *a, int n, limb_t b) {
+    wide_t carry = 0;
+    for (int i = 0; i < n; ++i) {
+        carry += static_cast<wide_t>(a[i]) * b + r[i];
+        r[i] = static_cast<limb_t>(carry % kBASE);
+        carry /= kBASE;
+    }
+    return static_cast<limb_t>(carry);
+}
+
+}  // namespace kernel
+
 // ============================================================================
 // Addition and Subtraction Helper Functions
 // ============================================================================
@@ -143,23 +503,9 @@ int2048 add(int2048 a, const int2048 &b) {
     }
     
     // Both numbers are positive
-    int maxlen = std::max(a.vals_.size(), b.vals_.size());
+    int maxlen = std::max(a.len(), b.len());
     a.vals_.resize(maxlen + 1);
-    
-    bool carry = false;
-    for (int i = 0; i < static_cast<int>(b.vals_.size()) || carry; ++i) {
-        if (i < static_cast<int>(b.vals_.size())) {
-            a.vals_[i] += b.vals_[i];
-        }
-        
-        if (a.vals_[i] >= kBASE) {
-            a.vals_[i + 1]++;
-            a.vals_[i] -= kBASE;
-            carry = true;
-        } else {
-            carry = false;
-        }
-    }
+    a.vals_[maxlen] = kernel::add(a.vals_.data(), a.vals_.data(), maxlen, b.vals_.data(), b.len());
     
     // Remove leading zeros
     while (a.vals_.size() > 1 && a.vals_.back() == 0) {
@@ -190,22 +536,8 @@ int2048 minus(int2048 a, const int2048 &b) {
         return -minus(b, a);
     }
     
-    a.vals_.resize(a.vals_.size() + 1);
-    
-    bool borrow = false;
-    for (int i = 0; i < static_cast<int>(b.vals_.size()) || borrow; ++i) {
-        if (i < static_cast<int>(b.vals_.size())) {
-            a.vals_[i] -= b.vals_[i];
-        }
-        
-        if (a.vals_[i] < 0) {
-            a.vals_[i] += kBASE;
-            a.vals_[i + 1]--;
-            borrow = true;
-        } else {
-            borrow = false;
-        }
-    }
+    // a >= b, so the borrow never runs past the top limb
+    kernel::sub(a.vals_.data(), a.vals_.data(), a.len(), b.vals_.data(), b.len());
     
     // Remove leading zeros
     while (a.vals_.size() > 1 && a.vals_.back() == 0) {
@@ -282,35 +614,8 @@ std::istream &operator>>(std::istream &in, int2048 &a) {
     return in;
 }
 
-/**
- * Output operator for int2048
- * WARNING: This implementation depends on kBASE and kLEN constants!
- * kBASE must be 1000 and kLEN must be 3 for proper zero-padding
- */
 std::ostream &operator<<(std::ostream &out, const int2048 &a) {
-    // Print negative sign for non-zero negative numbers
-    if (a.sign_bit_ == -1 && (a.vals_.size() > 1 || a.vals_[0] != 0)) {
-        out << '-';
-    }
-    
-    // Print digits from most significant to least significant
-    for (int i = static_cast<int>(a.vals_.size()) - 1; i >= 0; --i) {
-        if (i == static_cast<int>(a.vals_.size()) - 1) {
-            // Most significant digit: no leading zeros
-            out << a.vals_[i];
-        } else {
-            // Other digits: pad with zeros to kLEN digits
-            if (a.vals_[i] >= 100) {
-                out << a.vals_[i];
-            } else if (a.vals_[i] >= 10) {
-                out << '0' << a.vals_[i];
-            } else {
-                out << "00" << a.vals_[i];
-            }
-        }
-    }
-    
-    return out;
+    return out << std::string(a);
 }
 
 // ============================================================================
@@ -426,53 +731,131 @@ bool operator>(const int2048 &a, const int2048 &b) {
 // Polynomial Conversion (for FFT multiplication)
 // ============================================================================
 
-constexpr double eps = 1e-7;
+namespace polymul {
 
-poly int2048::to_poly() const {
-    poly result;
-    result.reserve(vals_.size());
-    
-    for (int x : vals_) {
-        result.push_back(x);
+/**
+ * Split limbs into FFT pieces, least significant first
+ * Decimal limbs are cut into kPieceDigits-digit groups; binary limbs are
+ * read as one bit stream and cut into kPieceBits-bit groups, so that piece
+ * products stay far below the 53-bit double mantissa for any limb width.
+ */
+template <class Policy = limb_policy>
+std::vector<int> split(const limb_t *data, int n) {
+    std::vector<int> pieces;
+    if constexpr (Policy::kDecimal) {
+        constexpr int kPerLimb = Policy::kDigits / Policy::kPieceDigits;
+        constexpr limb_t kPieceBase = static_cast<limb_t>(ipow10(Policy::kPieceDigits));
+        pieces.reserve(static_cast<size_t>(n) * kPerLimb);
+        for (int i = 0; i < n; ++i) {
+            limb_t x = data[i];
+            for (int j = 0; j < kPerLimb; ++j) {
+                pieces.push_back(static_cast<int>(x % kPieceBase));
+                x /= kPieceBase;
+            }
+        }
+    } else {
+        constexpr int kPieceBits = Policy::kPieceBits;
+        constexpr typename Policy::wide_t kMask = (typename Policy::wide_t(1) << kPieceBits) - 1;
+        pieces.reserve(static_cast<size_t>(n) * Policy::kBits / kPieceBits + 1);
+        typename Policy::wide_t buf = 0;
+        int bits = 0;
+        for (int i = 0; i < n; ++i) {
+            buf |= static_cast<typename Policy::wide_t>(data[i]) << bits;
+            bits += Policy::kBits;
+            while (bits >= kPieceBits) {
+                pieces.push_back(static_cast<int>(buf & kMask));
+                buf >>= kPieceBits;
+                bits -= kPieceBits;
+            }
+        }
+        if (bits > 0) {
+            pieces.push_back(static_cast<int>(buf));
+        }
     }
-    
+
     // Remove trailing zeros
-    while (result.size() > 1 && std::abs(result.back().real()) < eps) {
-        result.pop_back();
+    while (pieces.size() > 1 && pieces.back() == 0) {
+        pieces.pop_back();
     }
-    
-    return result;
+    return pieces;
 }
 
-int2048 int2048::to_int2048(const poly &a) const {
-    std::vector<long long> temp(a.size() + 1);
-    
-    // Convert complex numbers to integers with carry handling
-    for (int i = 0; i < static_cast<int>(a.size()); ++i) {
-        temp[i] += static_cast<long long>(a[i].imag() / 2.0 + 0.5);
-        temp[i + 1] += temp[i] / kBASE;
-        temp[i] %= kBASE;
+/**
+ * Carry uncarried piece coefficients and regroup them into limbs
+ * Inverse of split: coefficients are carried in the piece base first.
+ */
+template <class Policy = limb_policy>
+std::vector<limb_t> join(const std::vector<long long> &coeffs) {
+    std::vector<limb_t> vals;
+    long long carry = 0;
+    size_t i = 0;
+
+    if constexpr (Policy::kDecimal) {
+        constexpr int kPerLimb = Policy::kDigits / Policy::kPieceDigits;
+        constexpr long long kPieceBase = static_cast<long long>(ipow10(Policy::kPieceDigits));
+        vals.reserve(coeffs.size() / kPerLimb + 2);
+        while (i < coeffs.size() || carry > 0) {
+            limb_t limb = 0, scale = 1;
+            for (int j = 0; j < kPerLimb; ++j, ++i) {
+                if (i < coeffs.size()) {
+                    carry += coeffs[i];
+                }
+                limb += static_cast<limb_t>(carry % kPieceBase) * scale;
+                carry /= kPieceBase;
+                scale *= static_cast<limb_t>(kPieceBase);
+            }
+            vals.push_back(limb);
+        }
+    } else {
+        constexpr int kPieceBits = Policy::kPieceBits;
+        constexpr long long kMask = (1LL << kPieceBits) - 1;
+        vals.reserve(coeffs.size() * kPieceBits / Policy::kBits + 2);
+        typename Policy::wide_t buf = 0;
+        int bits = 0;
+        while (i < coeffs.size() || carry > 0) {
+            if (i < coeffs.size()) {
+                carry += coeffs[i++];
+            }
+            buf |= static_cast<typename Policy::wide_t>(carry & kMask) << bits;
+            carry >>= kPieceBits;
+            bits += kPieceBits;
+            if (bits >= Policy::kBits) {
+                vals.push_back(static_cast<limb_t>(buf));
+                buf >>= Policy::kBits;
+                bits -= Policy::kBits;
+            }
+        }
+        if (bits > 0) {
+            vals.push_back(static_cast<limb_t>(buf));
+        }
     }
-    
+
     // Remove leading zeros
-    while (temp.size() > 1 && temp.back() == 0) {
-        temp.pop_back();
+    while (vals.size() > 1 && vals.back() == 0) {
+        vals.pop_back();
     }
-    
-    // Convert to int2048
-    int2048 result;
-    result.vals_.clear();
-    result.vals_.reserve(temp.size());
-    
-    for (long long x : temp) {
-        result.vals_.push_back(static_cast<int>(x));
+    if (vals.empty()) {
+        vals.push_back(0);
     }
-    
-    // Remove any remaining leading zeros
-    while (result.vals_.size() > 1 && result.vals_.back() == 0) {
-        result.vals_.pop_back();
+    return vals;
+}
+
+}  // namespace polymul
+
+poly int2048::to_poly() const {
+    auto pieces = polymul::split(vals_.data(), len());
+    return poly(pieces.begin(), pieces.end());
+}
+
+int2048 int2048::to_int2048(const poly &a) const {
+    // The packed product carries 2ab in the imaginary part
+    std::vector<long long> coeffs(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        coeffs[i] = static_cast<long long>(a[i].imag() / 2.0 + 0.5);
     }
-    
+
+    int2048 result;
+    result.vals_ = polymul::join(coeffs);
     return result;
 }
 
@@ -598,25 +981,390 @@ poly mul(poly a, poly b) {
     }
     
     FFT(a, len, -1);
-    
+
     return a;
 }
 
+// Below this length the O(nm) schoolbook product is the fastest kernel
+constexpr int kSchoolbookLimit = 32;
+// Below this length Karatsuba beats a full FFT
+constexpr int kKaratsubaLimit = 512;
+// Operands whose lengths differ by at least this factor are multiplied blockwise
+constexpr int kUnbalancedRatio = 4;
+
+using acc_t = limb_policy::acc_t;
+
+/**
+ * Schoolbook multiplication, accumulated into out
+ * @param a First operand (n coefficients)
+ * @param b Second operand (m coefficients)
+ * @param out Accumulator with at least n + m - 1 entries
+ */
+template <class T>
+void schoolbook(const T *a, int n, const T *b, int m, acc_t *out) {
+    for (int i = 0; i < n; ++i) {
+        acc_t x = a[i];
+        if (x == 0) {
+            continue;
+        }
+        for (int j = 0; j < m; ++j) {
+            out[i + j] += x * b[j];
+        }
+    }
+}
+
+/**
+ * Karatsuba multiplication of two equal-length operands, accumulated into out
+ * Coefficients are left uncarried, so the operand sums may exceed kBASE
+ * @param a First operand (n coefficients)
+ * @param b Second operand (n coefficients)
+ * @param out Accumulator with at least 2n - 1 entries
+ */
+void karatsuba(const acc_t *a, const acc_t *b, int n, acc_t *out) {
+    if (n <= kSchoolbookLimit) {
+        schoolbook(a, n, b, n, out);
+        return;
+    }
+
+    int lo = n / 2, hi = n - lo;
+    std::vector<acc_t> sum_a(hi), sum_b(hi);
+    for (int i = 0; i < hi; ++i) {
+        sum_a[i] = a[lo + i] + (i < lo ? a[i] : 0);
+        sum_b[i] = b[lo + i] + (i < lo ? b[i] : 0);
+    }
+
+    std::vector<acc_t> z0(2 * lo), z1(2 * hi), z2(2 * hi);
+    karatsuba(a, b, lo, z0.data());
+    karatsuba(a + lo, b + lo, hi, z2.data());
+    karatsuba(sum_a.data(), sum_b.data(), hi, z1.data());
+
+    // (a0 + a1)(b0 + b1) - a0b0 - a1b1 = a0b1 + a1b0
+    for (int i = 0; i < 2 * lo; ++i) {
+        out[i] += z0[i];
+        z1[i] -= z0[i];
+    }
+    for (int i = 0; i < 2 * hi; ++i) {
+        out[2 * lo + i] += z2[i];
+        z1[i] -= z2[i];
+    }
+    for (int i = 0; i < 2 * hi; ++i) {
+        out[lo + i] += z1[i];
+    }
+}
+
+/**
+ * Multiply a long operand by a much shorter one on whole limbs
+ * The long operand is cut into blocks sized to the short one and every block
+ * product is added at its offset, so the cost is O(n / m * M(m)) instead of
+ * padding both operands to one transform of length 2n.
+ * @param a Long operand (n limbs)
+ * @param b Short operand (m limbs, m <= min(n, kKaratsubaLimit))
+ * @param out Accumulator with at least n + m - 1 entries
+ */
+void mul_blocks(const limb_t *a, int n, const limb_t *b, int m, acc_t *out) {
+    if (m <= kSchoolbookLimit) {
+        schoolbook(a, n, b, m, out);
+        return;
+    }
+
+    std::vector<acc_t> block(m), short_op(b, b + m), prod(2 * m);
+    for (int start = 0; start < n; start += m) {
+        int size = std::min(m, n - start);
+        std::fill(block.begin(), block.end(), 0);
+        std::copy(a + start, a + start + size, block.begin());
+        std::fill(prod.begin(), prod.end(), 0);
+        karatsuba(block.data(), short_op.data(), m, prod.data());
+        for (int i = 0; i < size + m - 1; ++i) {
+            out[start + i] += prod[i];
+        }
+    }
+}
+
+/**
+ * Schoolbook product with one carry chain per row: r = a * b
+ * @param r Output with n + m limbs, must not alias a or b
+ */
+void mul_basecase(limb_t *r, const limb_t *a, int n, const limb_t *b, int m) {
+    std::fill(r, r + n + m, 0);
+    for (int j = 0; j < m; ++j) {
+        r[n + j] = kernel::addmul_1(r + j, a, n, b[j]);
+    }
+}
+
+/**
+ * Karatsuba on carried limbs: r = a * b for equal-length operands
+ * Used when limb products are too wide to accumulate uncarried.
+ * @param r Output with 2n limbs, must not alias a or b
+ */
+void karatsuba_chains(limb_t *r, const limb_t *a, const limb_t *b, int n) {
+    if (n <= kSchoolbookLimit) {
+        mul_basecase(r, a, n, b, n);
+        return;
+    }
+
+    int lo = n / 2, hi = n - lo;
+    std::vector<limb_t> sum_a(hi + 1), sum_b(hi + 1), z1(2 * hi + 2);
+    sum_a[hi] = kernel::add(sum_a.data(), a + lo, hi, a, lo);
+    sum_b[hi] = kernel::add(sum_b.data(), b + lo, hi, b, lo);
+
+    karatsuba_chains(r, a, b, lo);
+    karatsuba_chains(r + 2 * lo, a + lo, b + lo, hi);
+    karatsuba_chains(z1.data(), sum_a.data(), sum_b.data(), hi + 1);
+
+    // (a0 + a1)(b0 + b1) - a0b0 - a1b1 = a0b1 + a1b0
+    int z1_len = 2 * hi + 2;
+    kernel::sub(z1.data(), z1.data(), z1_len, r, 2 * lo);
+    kernel::sub(z1.data(), z1.data(), z1_len, r + 2 * lo, 2 * hi);
+    while (z1_len > 0 && z1[z1_len - 1] == 0) {
+        z1_len--;
+    }
+    kernel::add(r + lo, r + lo, 2 * n - lo, z1.data(), z1_len);
+}
+
+/**
+ * Blockwise product on carried limbs: r = a * b
+ * Same decomposition as mul_blocks for policies with kCarryChains.
+ * @param r Zero-initialized output with n + m limbs
+ */
+void mul_blocks_chains(limb_t *r, const limb_t *a, int n, const limb_t *b, int m) {
+    if (m <= kSchoolbookLimit) {
+        mul_basecase(r, a, n, b, m);
+        return;
+    }
+
+    std::vector<limb_t> block(m), prod(2 * m);
+    for (int start = 0; start < n; start += m) {
+        int size = std::min(m, n - start);
+        std::fill(block.begin(), block.end(), 0);
+        std::copy(a + start, a + start + size, block.begin());
+        karatsuba_chains(prod.data(), block.data(), b, m);
+        int room = n + m - start;
+        kernel::add(r + start, r + start, room, prod.data(), std::min(2 * m, room));
+    }
+}
+
+/**
+ * Multiply a long piece sequence by a much shorter one with small FFTs
+ * The short operand is transformed once and reused for every block.
+ * @param a Long operand pieces
+ * @param b Short operand pieces
+ * @return Uncarried piece coefficients of the product
+ */
+std::vector<long long> fft_blocks(const std::vector<int> &a, const std::vector<int> &b) {
+    int n = static_cast<int>(a.size()), m = static_cast<int>(b.size());
+    std::vector<long long> out(n + m - 1);
+
+    int bit = 1, len = 2;
+    while (len < 2 * m) {
+        bit++;
+        len <<= 1;
+    }
+    int block_size = len - m + 1;
+    init(bit);
+
+    poly short_op(len);
+    for (int i = 0; i < m; ++i) {
+        short_op[i] = Complex(b[i], 0);
+    }
+    FFT(short_op, len, 1);
+
+    poly block(len);
+    for (int start = 0; start < n; start += block_size) {
+        int size = std::min(block_size, n - start);
+        for (int i = 0; i < len; ++i) {
+            block[i] = Complex(i < size ? a[start + i] : 0, 0);
+        }
+        FFT(block, len, 1);
+        for (int i = 0; i < len; ++i) {
+            block[i] *= short_op[i];
+        }
+        FFT(block, len, -1);
+        for (int i = 0; i < size + m - 1; ++i) {
+            out[start + i] += static_cast<long long>(block[i].real() + 0.5);
+        }
+    }
+    return out;
+}
+
 }  // namespace polymul
 
+// ============================================================================
+// Limb Views
+// ============================================================================
+
+int limb_view::len() const {
+    return size == 0 ? 0 : size + shift;
+}
+
+limb_t limb_view::limb(int i) const {
+    return (i < shift || i >= shift + size) ? 0 : data[i - shift];
+}
+
+limb_view limb_view::shifted(int k) const {
+    return size == 0 ? *this : limb_view{data, size, shift + k};
+}
+
+limb_view limb_view::high(int k) const {
+    if (k <= shift) {
+        return {data, size, shift - k};
+    }
+    k -= shift;
+    if (k >= size) {
+        return {};
+    }
+    return {data + k, size - k, 0};
+}
+
+limb_view limb_view::low(int k) const {
+    if (k <= shift) {
+        return {};
+    }
+    return limb_view{data, std::min(size, k - shift), shift}.trimmed();
+}
+
+limb_view limb_view::trimmed() const {
+    limb_view v = *this;
+    while (v.size > 0 && v.data[v.size - 1] == 0) {
+        v.size--;
+    }
+    if (v.size == 0) {
+        v.shift = 0;
+    }
+    return v;
+}
+
+limb_view int2048::view() const {
+    return limb_view{vals_.data(), len(), 0}.trimmed();
+}
+
+/**
+ * Compare the magnitudes of two views
+ * @return Negative, zero or positive as a is less than, equal to or greater than b
+ */
+int compare(const limb_view &a, const limb_view &b) {
+    if (a.len() != b.len()) {
+        return a.len() < b.len() ? -1 : 1;
+    }
+    for (int i = a.len() - 1; i >= 0; --i) {
+        if (a.limb(i) != b.limb(i)) {
+            return a.limb(i) < b.limb(i) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Multiply the magnitudes of two views
+ * Only the stored limbs are multiplied; the implicit low zeros of both
+ * operands are added back when the product is materialized.
+ * @return Non-negative product
+ */
+int2048 mul(const limb_view &a, const limb_view &b) {
+    if (a.size == 0 || b.size == 0) {
+        return 0;
+    }
+
+    const limb_view &lng = (a.size >= b.size) ? a : b;
+    const limb_view &shrt = (a.size >= b.size) ? b : a;
+    int n = lng.size, m = shrt.size;
+    int shift = a.shift + b.shift;
+    bool unbalanced = n >= polymul::kUnbalancedRatio * m;
+
+    if (m <= polymul::kKaratsubaLimit && (unbalanced || n <= polymul::kKaratsubaLimit)) {
+        // Short or strongly unbalanced operands: blockwise kernels on whole limbs
+        if constexpr (limb_policy::kCarryChains) {
+            int2048 result;
+            result.vals_.assign(shift + n + m, 0);
+            polymul::mul_blocks_chains(result.vals_.data() + shift, lng.data, n, shrt.data, m);
+            while (result.vals_.size() > 1 && result.vals_.back() == 0) {
+                result.vals_.pop_back();
+            }
+            return result;
+        } else {
+            std::vector<limb_policy::acc_t> coeffs(shift + n + m - 1);
+            polymul::mul_blocks(lng.data, n, shrt.data, m, coeffs.data() + shift);
+            return int2048::from_coeffs(coeffs);
+        }
+    }
+
+    // Long operands: FFT over pieces small enough for double precision
+    auto pieces_a = polymul::split(lng.data, n);
+    auto pieces_b = polymul::split(shrt.data, m);
+    int2048 result;
+    if (unbalanced) {
+        result.vals_ = polymul::join(polymul::fft_blocks(pieces_a, pieces_b));
+    } else {
+        poly poly_a(pieces_a.begin(), pieces_a.end()), poly_b(pieces_b.begin(), pieces_b.end());
+        result = int2048(polymul::mul(poly_a, poly_b));
+    }
+    return result.left_shift(shift);
+}
+
+/**
+ * Signed difference of two magnitudes
+ * @return a - b
+ */
+int2048 sub(const limb_view &a, const limb_view &b) {
+    int order = compare(a, b);
+    if (order == 0) {
+        return 0;
+    }
+    const limb_view &big = (order > 0) ? a : b;
+    const limb_view &small = (order > 0) ? b : a;
+
+    int2048 result;
+    result.vals_.assign(big.len(), 0);
+    limb_t borrow = 0;
+    for (int i = 0; i < big.len(); ++i) {
+        limb_policy::wide_t x = big.limb(i);
+        limb_policy::wide_t y = static_cast<limb_policy::wide_t>(small.limb(i)) + borrow;
+        borrow = (x < y);
+        result.vals_[i] = static_cast<limb_t>(x + (borrow ? kBASE : 0) - y);
+    }
+
+    // Remove leading zeros
+    while (result.vals_.size() > 1 && result.vals_.back() == 0) {
+        result.vals_.pop_back();
+    }
+
+    result.sign_bit_ = order;
+    return result;
+}
+
 // ============================================================================
 // Multiplication Operators
 // ============================================================================
 
+int2048 int2048::from_coeffs(const std::vector<limb_policy::acc_t> &coeffs) {
+    int2048 result;
+    result.vals_.clear();
+    result.vals_.reserve(coeffs.size() + 2);
+
+    limb_policy::acc_t carry = 0;
+    for (limb_policy::acc_t x : coeffs) {
+        carry += x;
+        result.vals_.push_back(static_cast<limb_t>(carry % kBASE));
+        carry /= kBASE;
+    }
+    while (carry > 0) {
+        result.vals_.push_back(static_cast<limb_t>(carry % kBASE));
+        carry /= kBASE;
+    }
+
+    // Remove leading zeros
+    while (result.vals_.size() > 1 && result.vals_.back() == 0) {
+        result.vals_.pop_back();
+    }
+
+    return result;
+}
+
 int2048 operator*(int2048 a, const int2048 &b) {
-    // Convert to polynomials and multiply using FFT
-    auto poly_a = a.to_poly();
-    auto poly_b = b.to_poly();
-    auto result = int2048(polymul::mul(poly_a, poly_b));
-    
+    int2048 result = mul(a.view(), b.view());
+
     // Set sign: positive if same sign, negative if different
     result.sign_bit_ = (a.sign_bit_ == b.sign_bit_) ? 1 : -1;
-    
+
     return result;
 }
 
@@ -633,19 +1381,10 @@ int2048 &int2048::left_shift(const int k) {
     if (k <= 0) {
         return *this;
     }
-    
-    vals_.resize(vals_.size() + k);
-    
-    // Shift digits to the left
-    for (int i = static_cast<int>(vals_.size()) - 1; i >= k; --i) {
-        vals_[i] = vals_[i - k];
-    }
-    
-    // Fill with zeros
-    for (int i = 0; i < k; ++i) {
-        vals_[i] = 0;
-    }
-    
+
+    // One memmove instead of shifting element by element
+    vals_.insert(vals_.begin(), k, 0);
+
     return *this;
 }
 
@@ -653,21 +1392,14 @@ int2048 &int2048::right_shift(const int k) {
     if (k <= 0) {
         return *this;
     }
-    
+
     if (k >= static_cast<int>(vals_.size())) {
         return (*this = 0);
     }
-    
-    // Shift digits to the right
-    for (int i = k; i < static_cast<int>(vals_.size()); ++i) {
-        vals_[i - k] = vals_[i];
-    }
-    
-    // Remove shifted digits
-    for (int i = 0; i < k; ++i) {
-        vals_.pop_back();
-    }
-    
+
+    // Drop the low limbs in one memmove
+    vals_.erase(vals_.begin(), vals_.begin() + k);
+
     return *this;
 }
 
@@ -720,37 +1452,36 @@ int2048 force_div(const int2048 &a, const int2048 &b) {
 /**
  * Newton's method to compute reciprocal: 10^{2m} / b
  * Uses Newton iteration: x_{n+1} = 2*x_n - b*x_n^2
+ * Truncations and power-of-base shifts are taken on views, so only the
+ * products and the new iterate are materialized.
  * @param b Divisor
  * @return Approximation of 10^{2m} / b
  */
-int2048 newton_inv(const int2048 &b) {
+int2048 newton_inv(const limb_view &b) {
+    int m = b.len();
+
     // Base case: use brute force for small numbers
-    if (b.len() <= kLEN * 10) {
+    if (m <= limb_policy::kNewtonLimit) {
         int2048 numerator = 1;
-        numerator.left_shift(2 * b.len());
-        return force_div(numerator, b);
+        numerator.left_shift(2 * m);
+        return force_div(numerator, int2048(b));
     }
-    
-    int m = b.len();
+
     int k = (m + 1) / 2 + 2;
-    
+
     // Recursively compute inverse of truncated b
-    int2048 b_truncated = b;
-    b_truncated.right_shift(m - k);
-    
-    auto inverse_approx = newton_inv(b_truncated);
-    
+    auto inverse_approx = newton_inv(b.high(m - k));
+
     // Newton iteration step
-    auto result = (int2048(2) * inverse_approx).left_shift(m - k) - 
-                  (b * inverse_approx * inverse_approx).right_shift(2 * k);
-    
-    // Correction step
-    int2048 numerator = 1;
-    numerator.left_shift(2 * m);
-    if (numerator <= result * b) {
+    auto twice = inverse_approx + inverse_approx;
+    auto square = mul(mul(b, inverse_approx.view()).view(), inverse_approx.view());
+    auto result = sub(twice.view().shifted(m - k), square.view().high(2 * k));
+
+    // Correction step: 10^{2m} <= result * b iff the product has 2m + 1 limbs
+    if (mul(result.view(), b).len() > 2 * m) {
         result -= 1;
     }
-    
+
     return result;
 }
 
@@ -761,33 +1492,41 @@ int2048 newton_inv(const int2048 &b) {
  * @param b Divisor
  * @return Quotient of a / b
  */
-int2048 div(int2048 a, int2048 b) {
+int2048 div(const int2048 &a, const int2048 &b) {
     if (a < b) {
         return 0;
     }
-    
-    int n = a.len();
-    int m = b.len();
-    
+
+    // Single-limb divisor: one pass of short division
+    if (b.len() == 1) {
+        int2048 quotient = a;
+        radix::divmod_1(quotient.vals_.data(), quotient.len(), b.vals_[0]);
+        while (quotient.vals_.size() > 1 && quotient.vals_.back() == 0) {
+            quotient.vals_.pop_back();
+        }
+        return quotient;
+    }
+
+    auto a_view = a.view();
+    auto b_view = b.view();
+    int n = a_view.len();
+    int m = b_view.len();
+
     // Normalize if a is much larger than b
     if (n > 2 * m) {
-        a.left_shift(n - 2 * m);
-        b.left_shift(n - 2 * m);
-        n = a.len();
-        m = b.len();
+        a_view = a_view.shifted(n - 2 * m);
+        b_view = b_view.shifted(n - 2 * m);
+        n = a_view.len();
+        m = b_view.len();
     }
-    
+
     // Compute reciprocal of b
-    int2048 numerator = 1;
-    numerator.left_shift(n);
-    
-    auto b_inverse = newton_inv(b);
-    b_inverse.right_shift(2 * m - n);
-    
+    auto b_inverse = newton_inv(b_view);
+
     // Multiply a by reciprocal of b
-    auto quotient = a * b_inverse;
-    quotient.right_shift(n);
-    
+    auto product = mul(a_view, b_inverse.view().high(2 * m - n));
+    int2048 quotient(product.view().high(n));
+
     // Correction step
     if (a >= (quotient + int2048(1)) * b) {
         quotient += 1;
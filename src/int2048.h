@@ -20,10 +20,97 @@
 namespace sjtu {
 using Complex = std::complex<double>;
 using poly = std::vector<Complex>;
-constexpr int kBASE = 1000, kLEN = 3;
+
+// ===================================
+// limb 策略
+// ===================================
+// 编译期选择每个 limb 的进制与宽度，打印、读入、FFT 拆位与除法按策略特化
+
+constexpr unsigned long long ipow10(int k) {
+  return k == 0 ? 1 : 10 * ipow10(k - 1);
+}
+
+// 十进制 limb：每个 limb 存 Digits 个十进制位
+template <int Digits>
+struct decimal_limbs {
+  static_assert(Digits >= 1 && Digits <= 9, "a decimal limb must fit in 32 bits");
+  using limb_t = unsigned int;
+  // 放得下 limb * limb + 进位的类型
+  using wide_t = unsigned long long;
+  // 未进位乘积系数的累加类型
+  using acc_t = typename std::conditional<(Digits <= 4), long long, __int128>::type;
+  static constexpr bool kDecimal = true;
+  // 乘法是否逐行进位（否则先累加未进位系数）
+  static constexpr bool kCarryChains = false;
+  static constexpr wide_t kBase = ipow10(Digits);
+  // 每个 limb 的十进制位数，读写时按此分块
+  static constexpr int kDigits = Digits;
+  // FFT 拆位：每个系数存 kPieceDigits 个十进制位
+  static constexpr int kPieceDigits = (Digits % 3 == 0) ? 3 : (Digits % 2 == 0 ? 2 : 1);
+  // 不超过此位数的除数直接用倍增除法
+  static constexpr int kNewtonLimit = 90 / Digits;
+};
+
+// 二进制 limb：每个 limb 存满 Bits 个二进制位
+template <int Bits>
+struct binary_limbs {
+  static_assert(Bits == 32 || Bits == 64, "binary limbs are 32 or 64 bits wide");
+  using limb_t = typename std::conditional<(Bits == 32), unsigned int, unsigned long long>::type;
+  using wide_t = typename std::conditional<(Bits == 32), unsigned long long, unsigned __int128>::type;
+  using acc_t = __int128;
+  static constexpr bool kDecimal = false;
+  // 64 位 limb 的乘积无法不进位地累加，改为 mulx/adc 式的逐行进位
+  static constexpr bool kCarryChains = (Bits == 64);
+  static constexpr wide_t kBase = wide_t(1) << Bits;
+  static constexpr int kBits = Bits;
+  // 一个 limb 一定放得下的十进制位数，读写时按此分块
+  static constexpr int kDigits = (Bits == 32) ? 9 : 19;
+  // FFT 拆位：每个系数存 kPieceBits 个二进制位
+  static constexpr int kPieceBits = 10;
+  static constexpr int kNewtonLimit = (Bits == 32) ? 10 : 6;
+};
+
+// 由构建选项 INT2048_LIMB 选择（见 CMakeLists.txt）
+#if defined(SJTU_INT2048_LIMB_BIN64)
+using limb_policy = binary_limbs<64>;
+#elif defined(SJTU_INT2048_LIMB_BIN32)
+using limb_policy = binary_limbs<32>;
+#elif defined(SJTU_INT2048_LIMB_DEC9)
+using limb_policy = decimal_limbs<9>;
+#elif defined(SJTU_INT2048_LIMB_DEC4)
+using limb_policy = decimal_limbs<4>;
+#else
+using limb_policy = decimal_limbs<3>;
+#endif
+
+using limb_t = limb_policy::limb_t;
+constexpr limb_policy::wide_t kBASE = limb_policy::kBase;
+constexpr int kLEN = limb_policy::kDigits;
+
+// 只读 limb 视图：不拥有存储，表示 data[0, size) * kBASE^shift
+// 截断、按 kBASE 的幂移位、高低位拆分均为 O(1)，只有物化为 int2048 时才复制
+struct limb_view {
+  const limb_t *data = nullptr;
+  int size = 0;
+  int shift = 0;
+
+  // 位数（含低位补的 0），零的位数为 0
+  int len() const;
+  // 第 i 位
+  limb_t limb(int) const;
+  // 乘 kBASE^k
+  limb_view shifted(int) const;
+  // 除 kBASE^k（向下取整）
+  limb_view high(int) const;
+  // 模 kBASE^k
+  limb_view low(int) const;
+  // 去掉高位的 0
+  limb_view trimmed() const;
+};
+
 class int2048 {
  private:
-  std::vector<int> vals_;
+  std::vector<limb_t> vals_;
   int sign_bit_;
 
  public:
@@ -33,6 +120,8 @@ class int2048 {
   int2048(const std::string &);
   int2048(const int2048 &);
   int2048(const poly &);
+  // 物化一个 limb 视图
+  explicit int2048(const limb_view &);
 
   // 析构函数
   ~int2048();
@@ -45,6 +134,8 @@ class int2048 {
 
   operator double() const;
   operator std::string() const;
+  // 若值放得下 long long，写入参数并返回 true
+  bool to_long_long(long long &) const;
 
   // 读入一个大整数
   void read(const std::string &);
@@ -55,6 +146,8 @@ class int2048 {
   poly to_poly() const;
   // 压位：将 complex vector 转换回 int2048
   int2048 to_int2048(const poly &) const;
+  // 进位：将未进位的乘积系数转换为 int2048
+  static int2048 from_coeffs(const std::vector<limb_policy::acc_t> &);
 
   // 加上一个大整数
   int2048 &add(const int2048 &);
@@ -100,20 +193,27 @@ class int2048 {
   friend bool operator<=(const int2048 &, const int2048 &);
   friend bool operator>=(const int2048 &, const int2048 &);
 
+  // 无符号视图运算：比较、乘积、带符号差
+  friend int compare(const limb_view &, const limb_view &);
+  friend int2048 mul(const limb_view &, const limb_view &);
+  friend int2048 sub(const limb_view &, const limb_view &);
+
   // 暴力倍增除法
   friend int2048 force_div(const int2048 &, const int2048 &);
   // 牛顿迭代法求 10^{2m} / b
-  friend int2048 newton_inv(const int2048 &);
+  friend int2048 newton_inv(const limb_view &);
   // 返回两个大整数的商
-  friend int2048 div(int2048, int2048);
+  friend int2048 div(const int2048 &, const int2048 &);
 
-  // 乘 10^(k * kLEN)
+  // 乘 kBASE^k
   int2048 &left_shift(const int);
-  // 除 10^(k * kLEN)
+  // 除 kBASE^k
   int2048 &right_shift(const int);
 
   // 返回当前有多少位
   int len() const;
+  // 返回绝对值的视图
+  limb_view view() const;
 };
 
 
@@ -1,20 +1,48 @@
-#include "Evalvisitor.h"
+#include "Closure.h"
+#include "Fold.h"
+#include "Interpreter.h"
+#include "Lower.h"
+#include "Memo.h"
+#include "Options.h"
+#include "Resolve.h"
+#include "VM.h"
 #include "Python3Lexer.h"
 #include "Python3Parser.h"
 #include "antlr4-runtime.h"
 #include <iostream>
+#include <iterator>
+#include <string>
 using namespace antlr4;
 // TODO: regenerating files in directory named "generated" is dangerous.
 //       if you really need to regenerate,please ask TA for help.
 int main(int argc, const char *argv[]) {
-	// TODO: please don't modify the code below the construction of ifs if you want to use visitor mode
-	ANTLRInputStream input(std::cin);
-	Python3Lexer lexer(&input);
-	CommonTokenStream tokens(&lexer);
-	tokens.fill();
-	Python3Parser parser(&tokens);
-	tree::ParseTree *tree = parser.file_input();
-	EvalVisitor visitor;
-	visitor.visit(tree);
+	ParseOptions(argc, argv);
+	Program program;
+	{
+		std::string source((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+		// Comments never reach the parse tree, so `# @memo` is read from the text
+		for (auto &name : MemoPragmas(source)) {
+			options.memo_.push_back(name);
+		}
+		ANTLRInputStream input(source);
+		Python3Lexer lexer(&input);
+		CommonTokenStream tokens(&lexer);
+		tokens.fill();
+		Python3Parser parser(&tokens);
+		Lower(parser.file_input(), program);
+	}
+	Fold(program);
+	Resolve(program);
+	// The parse tree, tokens and input text are gone; only the lowered tree runs
+	if (options.engine_ == kVMENGINE) {
+		VM vm(program);
+		vm.Run();
+	} else if (options.engine_ == kCLOSUREENGINE) {
+		ClosureEngine engine(program);
+		engine.Run();
+	} else {
+		Interpreter interpreter(program);
+		interpreter.Run();
+	}
 	return 0;
 }
@@ -1,235 +1,566 @@
 #include "operator.h"
+#include "FloatFormat.h"
 #include "int2048.h"
-#include <any>
+#include "Options.h"
+#include "Value.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <climits>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
 
-sjtu::int2048 GetInt(const std::any &a) {
-  if (a.type() == typeid(sjtu::int2048)) {
-    return std::any_cast<sjtu::int2048>(a);
-  } else if (a.type() == typeid(std::string)) {
-    return sjtu::int2048(std::any_cast<std::string>(a));
-  } else if (a.type() == typeid(bool)) {
-    return sjtu::int2048(std::any_cast<bool>(a) ? 1 : 0);
-  } else if (a.type() == typeid(double)){
-    return sjtu::int2048((long long)(std::any_cast<double>(a)));
-  } else {
-    return sjtu::int2048(0);
-  }
-}
-bool GetBool(const std::any &a) {
-  if (a.type() == typeid(bool)) {
-    return std::any_cast<bool>(a);
-  } else if (a.type() == typeid(std::string)) {
-    return std::any_cast<std::string>(a) != "";
-  } else if (a.type() == typeid(sjtu::int2048)) {
-    return std::any_cast<sjtu::int2048>(a) != sjtu::int2048(0);
-  } else if (a.type() == typeid(double)) {
-    return std::any_cast<double>(a) != 0;
-  } else {
-    return false;
-  }
-}
-double GetFlout(const std::any &a) {
-  if (a.type() == typeid(bool)) {
-    return std::any_cast<bool>(a) ? 1.0 : 0.0;
-  } else if (a.type() == typeid(std::string)) {
-    return stod(std::any_cast<std::string>(a));
-  } else if (a.type() == typeid(sjtu::int2048)) {
-    return double(std::any_cast<sjtu::int2048>(a));
-  } else if (a.type() == typeid(double)) {
-    return std::any_cast<double>(a);
-  } else {
-    return 0.0;
-  }
-}
-std::string GetString(const std::any &a) {
-  if (a.type() == typeid(bool)) {
-    return std::any_cast<bool>(a) ? "True" : "False";
-  } else if (a.type() == typeid(std::string)) {
-    return std::any_cast<std::string>(a);
-  } else if (a.type() == typeid(sjtu::int2048)) {
-    return std::string(std::any_cast<sjtu::int2048>(a));
-  } else if (a.type() == typeid(double)) {
-    return std::to_string(std::any_cast<double>(a));
-  } else if (!a.has_value()) {
-    return std::string("None");
-  } else {
-    return "";
+// Ints and bools that fit in 64 bits take the inline fast paths
+static bool GetSmall(const Value &a, long long &x) {
+  if (a.GetType() == Value::kINT) {
+    x = a.SmallInt();
+    return true;
+  } else if (a.GetType() == Value::kBOOL) {
+    x = a.Bool() ? 1 : 0;
+    return true;
   }
-} 
+  return false;
+}
 
-std::any operator + (const std::any &a) {
+sjtu::int2048 GetInt(const Value &a) {
+  switch (a.GetType()) {
+    case Value::kINT:
+      return sjtu::int2048(a.SmallInt());
+    case Value::kBIGINT:
+      return a.BigInt();
+    case Value::kSTR:
+      return sjtu::int2048(a.Str());
+    case Value::kBOOL:
+      return sjtu::int2048(a.Bool() ? 1 : 0);
+    case Value::kFLOAT:
+      return sjtu::int2048((long long)(a.Float()));
+    default:
+      return sjtu::int2048(0);
+  }
+}
+bool GetBool(const Value &a) {
+  switch (a.GetType()) {
+    case Value::kBOOL:
+      return a.Bool();
+    case Value::kSTR:
+      return a.Str() != "";
+    case Value::kINT:
+      return a.SmallInt() != 0;
+    case Value::kBIGINT:
+      // Values that fit in 64 bits are stored inline, so a big int is never 0
+      return true;
+    case Value::kFLOAT:
+      return a.Float() != 0;
+    default:
+      return false;
+  }
+}
+double GetFlout(const Value &a) {
+  switch (a.GetType()) {
+    case Value::kBOOL:
+      return a.Bool() ? 1.0 : 0.0;
+    case Value::kSTR:
+      return ParseFloat(a.Str());
+    case Value::kINT:
+      return double(a.SmallInt());
+    case Value::kBIGINT:
+      return double(a.BigInt());
+    case Value::kFLOAT:
+      return a.Float();
+    default:
+      return 0.0;
+  }
+}
+Borrowed<sjtu::int2048> BorrowInt(const Value &a) {
+  if (a.GetType() == Value::kBIGINT) {
+    return Borrowed<sjtu::int2048>(a.BigInt());
+  }
+  return Borrowed<sjtu::int2048>(GetInt(a));
+}
+Borrowed<std::string> BorrowString(const Value &a) {
+  if (a.GetType() == Value::kSTR) {
+    return Borrowed<std::string>(a.Str());
+  }
+  return Borrowed<std::string>(GetString(a));
+}
+std::string GetString(const Value &a) {
+  switch (a.GetType()) {
+    case Value::kBOOL:
+      return a.Bool() ? "True" : "False";
+    case Value::kSTR:
+      return a.Str();
+    case Value::kINT:
+      return std::to_string(a.SmallInt());
+    case Value::kBIGINT:
+      return std::string(a.BigInt());
+    case Value::kFLOAT:
+      return FormatFloat(a.Float());
+    case Value::kNONE:
+      return std::string("None");
+    default:
+      return "";
+  }
+}
+
+Value operator + (const Value &a) {
   return a;
 }
-std::any operator - (const std::any &a) {
-  if (a.type() == typeid(std::string)) {
+Value operator - (const Value &a) {
+  if (a.IsStr()) {
     // throw invalid operator
-    std::cerr << "test " << std::any_cast<std::string>(a) << "\n";
+    std::cerr << "test " << a.Str() << "\n";
     assert("invalid operator" == 0);
   }
-  if (a.type() == typeid(double)) {
-    return -*std::any_cast<double>(&a);
-  } 
-  return -*std::any_cast<sjtu::int2048>(&a);
+  if (a.IsFloat()) {
+    return -a.Float();
+  }
+  long long x;
+  if (GetSmall(a, x) && x != LLONG_MIN) {
+    return -x;
+  }
+  return -*BorrowInt(a);
+}
+
+// ============================================================================
+// Type-pair dispatch
+// ============================================================================
+// Each binary operator owns a table indexed by (lhs type, rhs type). The
+// entry is a kernel specialized for that pair, so the promotion rules below
+// are decided once when the table is built instead of on every call.
+
+constexpr int kTypeCount = Value::kTUPLE + 1;
+
+using BinaryKernel = Value (*)(const Value &, const Value &);
+using CompareKernel = bool (*)(const Value &, const Value &);
+
+// How a pair of operand types is evaluated
+enum PROMOTION {kSTRPAIR, kNONEPAIR, kFLOATPAIR, kSMALLPAIR, kBIGPAIR};
+
+constexpr bool IsSmallType(Value::Type t) {
+  return t == Value::kINT || t == Value::kBOOL;
 }
 
-std::any operator + (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    return GetString(a) + GetString(b);
+constexpr PROMOTION Promote(Value::Type a, Value::Type b) {
+  if (a == Value::kSTR || b == Value::kSTR) {
+    return kSTRPAIR;
+  } else if (a == Value::kFLOAT || b == Value::kFLOAT) {
+    return kFLOATPAIR;
+  } else if (IsSmallType(a) && IsSmallType(b)) {
+    return kSMALLPAIR;
+  } else if (a == Value::kNONE || b == Value::kNONE) {
+    return kNONEPAIR;
+  } else {
+    return kBIGPAIR;
   }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) + GetFlout(b);
+}
+
+// Operand conversions specialized on the static type of the operand
+template <Value::Type T>
+long long AsSmall(const Value &a) {
+  if constexpr (T == Value::kBOOL) {
+    return a.Bool() ? 1 : 0;
+  } else {
+    return a.SmallInt();
   }
-  return GetInt(a) + GetInt(b);
 }
-std::any operator - (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    // throw unvalid operation
-    assert("unvalid operation" == 0);
+
+template <Value::Type T>
+double AsFloat(const Value &a) {
+  if constexpr (T == Value::kFLOAT) {
+    return a.Float();
+  } else if constexpr (IsSmallType(T)) {
+    return double(AsSmall<T>(a));
+  } else {
+    return GetFlout(a);
   }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) - GetFlout(b);
+}
+
+template <Value::Type T>
+Borrowed<sjtu::int2048> AsBig(const Value &a) {
+  if constexpr (T == Value::kBIGINT) {
+    return Borrowed<sjtu::int2048>(a.BigInt());
+  } else if constexpr (IsSmallType(T)) {
+    return Borrowed<sjtu::int2048>(sjtu::int2048(AsSmall<T>(a)));
+  } else {
+    return Borrowed<sjtu::int2048>(GetInt(a));
   }
-  return GetInt(a) - GetInt(b);
 }
-std::any operator * (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) && b.type() == typeid(std::string)) {
-    // throw unvalid operation
-    assert("unvalid operation" == 0);
+
+Value InvalidOperation(const Value &, const Value &) {
+  // throw unvalid operation
+  assert("unvalid operation" == 0);
+  return Value();
+}
+
+// s * count: counts <= 0 give "", the output is sized once and filled by
+// doubling copies, and results above options.max_str_bytes_ are refused
+Value Repeat(const std::string &s, const Value &count) {
+  long long n;
+  if (count.GetType() == Value::kINT) {
+    n = count.SmallInt();
+  } else {
+    auto t = BorrowInt(count);
+    if (!t->to_long_long(n)) {
+      n = *t < sjtu::int2048(0LL) ? 0 : LLONG_MAX;
+    }
+  }
+  if (n <= 0 || s.empty()) {
+    return std::string();
   }
-  if (a.type() == typeid(std::string)) {
-    std::string s = GetString(a);
-    sjtu::int2048 t = GetInt(b);
-    std::string ans = "";
-    for (sjtu::int2048 i = 0; i < t; i += 1) {
-      ans = ans + s;
+  if (static_cast<unsigned long long>(n) > options.max_str_bytes_ / s.size()) {
+    RuntimeError("MemoryError: string repetition exceeds " +
+                 std::to_string(options.max_str_bytes_) + " bytes");
+  }
+
+  size_t total = s.size() * static_cast<size_t>(n);
+  std::string ans(total, '\0');
+  std::memcpy(&ans[0], s.data(), s.size());
+  for (size_t filled = s.size(); filled < total; filled *= 2) {
+    std::memcpy(&ans[filled], ans.data(), std::min(filled, total - filled));
+  }
+  return ans;
+}
+
+struct AddOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (A == Value::kSTR && B == Value::kSTR) {
+      return Value::Concat(a, b);
+    } else if constexpr (A == Value::kSTR) {
+      return Value::Concat(a, GetString(b));
+    } else if constexpr (B == Value::kSTR) {
+      return Value::Concat(GetString(a), b);
+    } else if constexpr (kind == kFLOATPAIR) {
+      return AsFloat<A>(a) + AsFloat<B>(b);
+    } else if constexpr (kind == kSMALLPAIR) {
+      long long z;
+      if (!__builtin_add_overflow(AsSmall<A>(a), AsSmall<B>(b), &z)) {
+        return z;
+      }
     }
-    return ans;
-  }
-  if (b.type() == typeid(std::string)) {
-    std::string s = GetString(b);
-    sjtu::int2048 t = GetInt(a);
-    std::string ans = "";
-    for (sjtu::int2048 i = 0; i < t; i += 1) {
-      ans = ans + s;
+    return *AsBig<A>(a) + *AsBig<B>(b);
+  }
+};
+
+struct SubOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (kind == kSTRPAIR) {
+      return InvalidOperation(a, b);
+    } else if constexpr (kind == kFLOATPAIR) {
+      return AsFloat<A>(a) - AsFloat<B>(b);
+    } else {
+      if constexpr (kind == kSMALLPAIR) {
+        long long z;
+        if (!__builtin_sub_overflow(AsSmall<A>(a), AsSmall<B>(b), &z)) {
+          return z;
+        }
+      }
+      return *AsBig<A>(a) - *AsBig<B>(b);
     }
-    return ans;
   }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) * GetFlout(b);
+};
+
+struct MulOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (A == Value::kSTR && B == Value::kSTR) {
+      return InvalidOperation(a, b);
+    } else if constexpr (A == Value::kSTR) {
+      return Repeat(a.Str(), b);
+    } else if constexpr (B == Value::kSTR) {
+      return Repeat(b.Str(), a);
+    } else if constexpr (kind == kFLOATPAIR) {
+      return AsFloat<A>(a) * AsFloat<B>(b);
+    } else {
+      if constexpr (kind == kSMALLPAIR) {
+        long long z;
+        if (!__builtin_mul_overflow(AsSmall<A>(a), AsSmall<B>(b), &z)) {
+          return z;
+        }
+      }
+      return *AsBig<A>(a) * *AsBig<B>(b);
+    }
   }
-  return GetInt(a) * GetInt(b);
-}
-std::any ForceDiv(const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    // throw unvalid operation
-    assert("unvalid operation" == 0);
+};
+
+struct ForceDivOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (kind == kSTRPAIR) {
+      return InvalidOperation(a, b);
+    } else if constexpr (kind == kFLOATPAIR) {
+      // Both sides are truncated to ints first, the quotient is a float
+      return double(GetInt(a) / *BorrowInt(b));
+    } else {
+      if constexpr (kind == kSMALLPAIR) {
+        long long x = AsSmall<A>(a), y = AsSmall<B>(b);
+        if (y != 0 && !(x == LLONG_MIN && y == -1)) {
+          // Floor division, as int2048 does
+          long long q = x / y;
+          if (x % y != 0 && ((x < 0) != (y < 0))) {
+            q--;
+          }
+          return q;
+        }
+      }
+      return *AsBig<A>(a) / *AsBig<B>(b);
+    }
   }
-  std::any res = GetInt(a) / GetInt(b);
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(res);
+};
+
+struct DivOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    if constexpr (Promote(A, B) == kSTRPAIR) {
+      return InvalidOperation(a, b);
+    } else {
+      return AsFloat<A>(a) / AsFloat<B>(b);
+    }
   }
-  return res;
-}
-std::any operator / (const std::any &a, const std::any &b)  {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    // throw unvalid operation
-    assert("unvalid operation" == 0);
+};
+
+struct ModOp {
+  template <Value::Type A, Value::Type B>
+  static Value Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (kind == kSTRPAIR) {
+      return InvalidOperation(a, b);
+    } else {
+      if constexpr (kind == kSMALLPAIR) {
+        long long x = AsSmall<A>(a), y = AsSmall<B>(b);
+        if (y != 0 && !(x == LLONG_MIN && y == -1)) {
+          long long r = x % y;
+          if (r != 0 && ((r < 0) != (y < 0))) {
+            r += y;
+          }
+          return r;
+        }
+      }
+      return a - b * ForceDiv(a, b);
+    }
   }
-  return GetFlout(a) / GetFlout(b);
-}
-std::any operator % (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    // throw unvalid operation
-    assert("unvalid operation" == 0);
+};
+
+// Ordering: strings only compare with strings, None falls back to ints
+template <template <class> class Cmp>
+struct OrderOp {
+  template <Value::Type A, Value::Type B>
+  static bool Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (kind == kSTRPAIR) {
+      if constexpr (A != B) {
+        return false;
+      } else {
+        return Cmp<std::string>()(a.Str(), b.Str());
+      }
+    } else if constexpr (kind == kFLOATPAIR) {
+      return Cmp<double>()(AsFloat<A>(a), AsFloat<B>(b));
+    } else if constexpr (kind == kSMALLPAIR) {
+      return Cmp<long long>()(AsSmall<A>(a), AsSmall<B>(b));
+    } else {
+      return Cmp<sjtu::int2048>()(*AsBig<A>(a), *AsBig<B>(b));
+    }
+  }
+};
+
+// Equality: as ordering, except None only equals None.
+// A string against any other type is neither == nor !=.
+template <bool kEqual>
+struct EqualOp {
+  template <Value::Type A, Value::Type B>
+  static bool Apply(const Value &a, const Value &b) {
+    constexpr PROMOTION kind = Promote(A, B);
+    if constexpr (kind == kSTRPAIR) {
+      if constexpr (A != B) {
+        return false;
+      } else {
+        return (a.Str() == b.Str()) == kEqual;
+      }
+    } else if constexpr (A == Value::kNONE || B == Value::kNONE) {
+      return (A == B) == kEqual;
+    } else if constexpr (kind == kFLOATPAIR) {
+      return (AsFloat<A>(a) == AsFloat<B>(b)) == kEqual;
+    } else if constexpr (kind == kSMALLPAIR) {
+      return (AsSmall<A>(a) == AsSmall<B>(b)) == kEqual;
+    } else {
+      return (*AsBig<A>(a) == *AsBig<B>(b)) == kEqual;
+    }
   }
-  return a - b * ForceDiv(a, b);
+};
+
+template <class Op, class Kernel, size_t... I>
+constexpr std::array<Kernel, sizeof...(I)> MakeTable(std::index_sequence<I...>) {
+  return {{&Op::template Apply<Value::Type(I / kTypeCount), Value::Type(I % kTypeCount)>...}};
 }
 
-std::any & operator += (std::any &a, const std::any &b) {
-  a = a + b;
+template <class Op, class Kernel = BinaryKernel>
+constexpr std::array<Kernel, kTypeCount * kTypeCount> MakeTable() {
+  return MakeTable<Op, Kernel>(std::make_index_sequence<kTypeCount * kTypeCount>());
+}
+
+constexpr auto kAddTable = MakeTable<AddOp>();
+constexpr auto kSubTable = MakeTable<SubOp>();
+constexpr auto kMulTable = MakeTable<MulOp>();
+constexpr auto kForceDivTable = MakeTable<ForceDivOp>();
+constexpr auto kDivTable = MakeTable<DivOp>();
+constexpr auto kModTable = MakeTable<ModOp>();
+constexpr auto kLessTable = MakeTable<OrderOp<std::less>, CompareKernel>();
+constexpr auto kGreaterTable = MakeTable<OrderOp<std::greater>, CompareKernel>();
+constexpr auto kEqualTable = MakeTable<EqualOp<true>, CompareKernel>();
+constexpr auto kNotEqualTable = MakeTable<EqualOp<false>, CompareKernel>();
+
+inline int PairIndex(const Value &a, const Value &b) {
+  return a.GetType() * kTypeCount + b.GetType();
+}
+
+Value operator + (const Value &a, const Value &b) {
+  return kAddTable[PairIndex(a, b)](a, b);
+}
+Value operator - (const Value &a, const Value &b) {
+  return kSubTable[PairIndex(a, b)](a, b);
+}
+Value operator * (const Value &a, const Value &b) {
+  return kMulTable[PairIndex(a, b)](a, b);
+}
+Value ForceDiv(const Value &a, const Value &b) {
+  return kForceDivTable[PairIndex(a, b)](a, b);
+}
+Value operator / (const Value &a, const Value &b)  {
+  return kDivTable[PairIndex(a, b)](a, b);
+}
+Value operator % (const Value &a, const Value &b) {
+  return kModTable[PairIndex(a, b)](a, b);
+}
+
+// Strings and big ints are updated in their box when it is not shared
+Value & operator += (Value &a, const Value &b) {
+  if (a.IsStr()) {
+    a.MutableStr() += *BorrowString(b);
+  } else if (a.GetType() == Value::kBIGINT && (b.IsInt() || b.IsBool())) {
+    a.MutableBigInt() += *BorrowInt(b);
+    a.ShrinkInt();
+  } else {
+    a = a + b;
+  }
   return a;
 }
-std::any & operator -= (std::any &a, const std::any &b) {
-  a = a - b;
+Value & operator -= (Value &a, const Value &b) {
+  if (a.GetType() == Value::kBIGINT && (b.IsInt() || b.IsBool())) {
+    a.MutableBigInt() -= *BorrowInt(b);
+    a.ShrinkInt();
+  } else {
+    a = a - b;
+  }
   return a;
 }
-std::any & operator *= (std::any &a, const std::any &b) {
+Value & operator *= (Value &a, const Value &b) {
   a = a * b;
   return a;
 }
-std::any & operator /= (std::any &a, const std::any &b) {
+Value & operator /= (Value &a, const Value &b) {
   a = a / b;
   return a;
 }
-std::any & operator %= (std::any &a, const std::any &b) {
+Value & operator %= (Value &a, const Value &b) {
   a = a % b;
   return a;
-} 
-std::any & ForceDivEqual(std::any &a, const std::any &b) {
+}
+Value & ForceDivEqual(Value &a, const Value &b) {
   a = ForceDiv(a, b);
   return a;
 }
 
-bool operator < (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    if (a.type() != b.type()) {
-      return false;
-    }
-    return std::any_cast<std::string>(a) < std::any_cast<std::string>(b);
-  }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) < GetFlout(b);
-  }
-  return GetInt(a) < GetInt(b);
+bool operator < (const Value &a, const Value &b) {
+  return kLessTable[PairIndex(a, b)](a, b);
 }
-bool operator > (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    if (a.type() != b.type()) {
-      return false;
-    }
-    return std::any_cast<std::string>(a) > std::any_cast<std::string>(b);
-  }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) > GetFlout(b);
-  }
-  return GetInt(a) > GetInt(b);
+bool operator > (const Value &a, const Value &b) {
+  return kGreaterTable[PairIndex(a, b)](a, b);
 }
-bool operator <= (const std::any &a, const std::any &b) {
+bool operator <= (const Value &a, const Value &b) {
   return !(a > b);
 }
-bool operator >= (const std::any &a, const std::any &b) {
+bool operator >= (const Value &a, const Value &b) {
   return !(a < b);
 }
-bool operator == (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    if (a.type() != b.type()) {
-      return false;
-    }
-    return std::any_cast<std::string>(a) == std::any_cast<std::string>(b);
-  }
-  if (!a.has_value() || !b.has_value()) {
-    return a.type() == b.type();
-  }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) == GetFlout(b);
+bool operator == (const Value &a, const Value &b) {
+  return kEqualTable[PairIndex(a, b)](a, b);
+}
+bool operator != (const Value &a, const Value &b) {
+  return kNotEqualTable[PairIndex(a, b)](a, b);
+}
+
+const char *OpName(OPKIND op) {
+  static const char *const kNames[] = {"+", "-", "*", "/", "//", "%", "<", ">", "<=", ">=", "==", "!="};
+  return kNames[op];
+}
+
+Value BinaryOp(OPKIND op, const Value &a, const Value &b) {
+  switch (op) {
+    case kADD:
+      return a + b;
+    case kSUB:
+      return a - b;
+    case kMUL:
+      return a * b;
+    case kDIV:
+      return a / b;
+    case kIDIV:
+      return ForceDiv(a, b);
+    case kMOD:
+      return a % b;
+    default:
+      return Value(CompareOp(op, a, b));
   }
-  return GetInt(a) == GetInt(b);
 }
-bool operator != (const std::any &a, const std::any &b) {
-  if (a.type() == typeid(std::string) || b.type() == typeid(std::string)) {
-    if (a.type() != b.type()) {
+
+bool CompareOp(OPKIND op, const Value &a, const Value &b) {
+  switch (op) {
+    case kLT:
+      return a < b;
+    case kGT:
+      return a > b;
+    case kLE:
+      return a <= b;
+    case kGE:
+      return a >= b;
+    case kEQ:
+      return a == b;
+    case kNE:
+      return a != b;
+    default:
+      assert("NOT A COMPARISON" == 0);
       return false;
-    }
-    return std::any_cast<std::string>(a) != std::any_cast<std::string>(b);
   }
-  if (!a.has_value() || !b.has_value()) {
-    return a.type() != b.type();
-  }
-  if (a.type() == typeid(double) || b.type() == typeid(double)) {
-    return GetFlout(a) != GetFlout(b);
+}
+
+void AugmentOp(OPKIND op, Value &a, const Value &b) {
+  switch (op) {
+    case kADD:
+      a += b;
+      break;
+    case kSUB:
+      a -= b;
+      break;
+    case kMUL:
+      a *= b;
+      break;
+    case kDIV:
+      a /= b;
+      break;
+    case kIDIV:
+      ForceDivEqual(a, b);
+      break;
+    case kMOD:
+      a %= b;
+      break;
+    default:
+      assert("NOT AN AUGMENTED OPERATOR" == 0);
   }
-  return GetInt(a) != GetInt(b);
 }
@@ -3,36 +3,75 @@
 #define OPERATOR_H
 
 #include "int2048.h"
-#include <any>
+#include "Value.h"
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <utility>
 
-sjtu::int2048 GetInt(const std::any &) ;
-std::string GetString(const std::any &);
-double GetFlout(const std::any &);
-bool GetBool(const std::any &);
-
-std::any operator + (const std::any &);
-std::any operator - (const std::any &);
-
-std::any operator + (const std::any &, const std::any &);
-std::any operator - (const std::any &, const std::any &);
-std::any operator * (const std::any &, const std::any &);
-std::any ForceDiv(const std::any &, const std::any &);
-std::any operator / (const std::any &, const std::any &);
-std::any operator % (const std::any &, const std::any &);
-
-std::any & operator += (std::any &, const std::any &); 
-std::any & operator -= (std::any &, const std::any &); 
-std::any & operator *= (std::any &, const std::any &); 
-std::any & operator /= (std::any &, const std::any &); 
-std::any & operator %= (std::any &, const std::any &); 
-std::any & ForceDivEqual(std::any &, const std::any &);
-
-bool operator < (const std::any &, const std::any &);
-bool operator > (const std::any &, const std::any &);
-bool operator <= (const std::any &, const std::any &);
-bool operator >= (const std::any &, const std::any &);
-bool operator == (const std::any &, const std::any &);
-bool operator != (const std::any &, const std::any &);
-
-#endif // OPERATOR_H
\ No newline at end of file
+sjtu::int2048 GetInt(const Value &) ;
+std::string GetString(const Value &);
+double GetFlout(const Value &);
+bool GetBool(const Value &);
+
+// A read-only operand of type T: refers to the stored payload when the value
+// already holds a T and owns a converted copy only when the type changes
+template <class T>
+class Borrowed {
+private:
+  std::optional<T> owned_;
+  const T *ptr_;
+
+public:
+  explicit Borrowed(const T &stored) : ptr_(&stored) {}
+  explicit Borrowed(T &&converted) : owned_(std::move(converted)), ptr_(&*owned_) {}
+  Borrowed(const Borrowed &) = delete;
+  Borrowed &operator=(const Borrowed &) = delete;
+
+  const T &operator*() const {
+    return *ptr_;
+  }
+  const T *operator->() const {
+    return ptr_;
+  }
+};
+
+Borrowed<sjtu::int2048> BorrowInt(const Value &);
+Borrowed<std::string> BorrowString(const Value &);
+
+Value operator + (const Value &);
+Value operator - (const Value &);
+
+Value operator + (const Value &, const Value &);
+Value operator - (const Value &, const Value &);
+Value operator * (const Value &, const Value &);
+Value ForceDiv(const Value &, const Value &);
+Value operator / (const Value &, const Value &);
+Value operator % (const Value &, const Value &);
+
+Value & operator += (Value &, const Value &);
+Value & operator -= (Value &, const Value &);
+Value & operator *= (Value &, const Value &);
+Value & operator /= (Value &, const Value &);
+Value & operator %= (Value &, const Value &);
+Value & ForceDivEqual(Value &, const Value &);
+
+bool operator < (const Value &, const Value &);
+bool operator > (const Value &, const Value &);
+bool operator <= (const Value &, const Value &);
+bool operator >= (const Value &, const Value &);
+bool operator == (const Value &, const Value &);
+bool operator != (const Value &, const Value &);
+
+// Binary operators as the lowered AST names them; comparisons come last
+enum OPKIND : uint8_t {kADD, kSUB, kMUL, kDIV, kIDIV, kMOD, kLT, kGT, kLE, kGE, kEQ, kNE};
+
+// The operator as written in source, e.g. "//"
+const char *OpName(OPKIND);
+
+Value BinaryOp(OPKIND, const Value &, const Value &);
+bool CompareOp(OPKIND, const Value &, const Value &);
+// a op= b, updating a in place where the operator allows it
+void AugmentOp(OPKIND, Value &, const Value &);
+
+#endif // OPERATOR_H
@@ -0,0 +1,51 @@
+def fib(n):
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+print(fib(20))
+a = 1
+b = 2
+a, b = b, a
+print(a, b)
+x = y = 7
+print(x, y)
+s = ""
+i = 0
+while i < 10:
+    i += 1
+    if i % 2 == 0:
+        continue
+    if i > 7:
+        break
+    s += str(i)
+print(s, i)
+print(7 // 2, -7 // 2, 7 % -3, -7 % 3)
+def g(a, b=10, c=20):
+    return a + b * c
+print(g(1), g(1, 2), g(1, c=3), g(a=5, b=1, c=1))
+def pair():
+    return 3, 4
+p, q = pair()
+print(p, q)
+print(1 < 2 < 3, 1 < 3 < 2, not 1 == 1, 1 != 2)
+print(f"x={x} s={s}{{}}")
+print("a" * 3, "ab" + "cd", "b" > "a")
+n = 1
+k = 0
+while k < 100:
+    n *= 3
+    k += 1
+print(n)
+print(n // 7 % 1000, -n % 13)
+def noret():
+    z = 1
+print(noret())
+print(int("123") + 1, str(45) + "6", bool(0), bool("x"))
+print(True and False, True or False, not (0 or 5 and 3))
+def early(n):
+    i = 0
+    while True:
+        if i == n:
+            return i * 10
+        i += 1
+print(early(5))
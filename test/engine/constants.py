@@ -0,0 +1,36 @@
+x = 60 * 60 * 24
+print(x)
+s = "a" + "b"
+print(s, "ab" * 3, 3 * "xy", "q" * 0)
+if 0:
+    print("dead")
+elif 1 < 2 < 3:
+    print("live")
+else:
+    print("dead too")
+if False:
+    print("no")
+while 0:
+    print("never")
+y = 7 // 2, -7 // 2, 7 % -3, 1 / 4, 2.5 // 1, -(3 - 5), not 0
+print(y)
+z = 0
+t = True and z
+print(t, 0 or False or z, z or 1, z and 0, 1 and 2 and z)
+def f(a, b=10 * 10):
+    if 1 == 1.0:
+        return a + b
+    return 0
+print(f(1))
+n = 5
+while n > 0 and True:
+    n -= 1
+    if "a" < "b":
+        continue
+    print("bad")
+print(n, 9223372036854775807 + 1, 2.0 * 3, 1 / 1)
+if n:
+    print("no")
+elif "":
+    print("no")
+print("end")
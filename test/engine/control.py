@@ -0,0 +1,50 @@
+def dfs(n):
+    if n == 0:
+        return 0
+    return dfs(n - 1) + 1
+print(dfs(500))
+def collatz(n):
+    steps = 0
+    while n != 1:
+        if n % 2 == 0:
+            n = n // 2
+        else:
+            n = 3 * n + 1
+        steps += 1
+    return steps
+best = 0
+arg = 0
+i = 1
+while i < 3000:
+    c = collatz(i)
+    if c > best:
+        best = c
+        arg = i
+    i += 1
+print(arg, best)
+s = "x"
+t = s
+s += "y"
+print(s, t)
+big = 1
+j = 0
+while j < 60:
+    big = big * 7 + j
+    j += 1
+print(big, big - big // 2 * 2, -big // 3)
+print(f"{1 + 2} and {'q' * 2} {big % 100}")
+def kw(a, b, c=3):
+    return a * 100 + b * 10 + c
+print(kw(1, 2), kw(b=5, a=4), kw(1, c=9, b=8))
+u = 0
+while u < 5:
+    u += 1
+    w = 0
+    while w < 5:
+        w += 1
+        if w == 3:
+            break
+    if u == 4:
+        continue
+    print(u, w)
+print("tab\tend", 'q"uote', "back\\slash")
@@ -0,0 +1,21 @@
+def add(a, b):
+    return a + b
+print(add(1, 2), add(1.5, 2.25), add("x", "y"), add(1, 2.5), add(9223372036854775807, 1))
+i = 0
+s = 0
+while i < 20:
+    x = i
+    if i % 4 == 0:
+        x = 0.5 * i
+    s = s + x * 2 - x // 1
+    if x < 3 or x >= 17.5:
+        s += 1
+    i += 1
+print(s)
+print(-7 // 2 + 0, 7 % -3 + 0, 1 / 4)
+a = -7
+b = 2
+print(a // b, a % b, a / b, a <= b, b >= a, a == a, a != b)
+f = 0.1
+g = 0.2
+print(f + g == 0.3, f < g, f <= g, g > f)
@@ -0,0 +1,24 @@
+x = 5
+def setx():
+    x = 7
+    y = 3
+    return y
+setx()
+print(x)
+def readlate():
+    print(x)
+    w = 1
+    print(w)
+readlate()
+def kw():
+    print(zz)
+kw(zz=4)
+def aug():
+    q += 1
+    return q
+print(aug())
+print(q)
+def shadow(x):
+    x += 100
+    return x
+print(shadow(1), x)
@@ -0,0 +1,23 @@
+def f(a=1):
+    return a
+i = 0
+while i < 4:
+    print(f())
+    if i == 1:
+        def f(a=10):
+            return a * 2
+    i += 1
+def g():
+    return 1
+def call():
+    return g()
+print(call())
+def g():
+    return 2
+print(call())
+def mk(v):
+    def h(x=v):
+        return x
+    return h()
+print(mk(3), mk(4))
+print(int("5") + 1, str(3), bool(0))
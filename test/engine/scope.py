@@ -0,0 +1,39 @@
+g = 1
+def f(a, b=2):
+    c = a + b + g
+    return c
+print(f(1), f(1, b=5), f(b=3, a=4))
+def h(n):
+    if n <= 1:
+        return 1
+    return n * h(n - 1)
+print(h(20))
+def k(x):
+    y = x
+    y += 1
+    z = y * 2
+    return z
+print(k(3))
+def m(p, q=10, r=20):
+    return p + q + r
+print(m(1), m(1, 2), m(1, r=3))
+cnt = 0
+def loop():
+    i = 0
+    s = 0
+    while i < 100:
+        s += i
+        i += 1
+    return s
+print(loop())
+def fib(n):
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+print(fib(15))
+def pair():
+    u, v = 1, 2
+    u, v = v, u
+    return u, v
+a1, a2 = pair()
+print(a1, a2)
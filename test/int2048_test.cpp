@@ -0,0 +1,142 @@
+// int2048 against Python-computed results, built once per limb policy
+// (ctest int2048_<policy>). Operands are decimal strings from a fixed
+// generator, sized to reach schoolbook, Karatsuba, unbalanced blockwise and
+// FFT multiplication, Newton division and the subquadratic radix
+// conversions; large results are compared by length and an FNV-1a hash of
+// their decimal text.
+#include "int2048.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void Check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::printf("FAIL %s\n", what.c_str());
+    failures++;
+  }
+}
+
+// n decimal digits from an LCG, leading digit nonzero
+std::string Digits(int n, uint64_t seed, bool negative) {
+  std::string s = negative ? "-" : "";
+  uint64_t x = seed;
+  for (int i = 0; i < n; i++) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    int d = static_cast<int>((x >> 33) % 10);
+    s += static_cast<char>('0' + (i == 0 && d == 0 ? 1 : d));
+  }
+  return s;
+}
+
+uint64_t Fnv(const std::string &s) {
+  uint64_t h = 1469598103934665603ULL;
+  for (unsigned char c : s) {
+    h = (h ^ c) * 1099511628211ULL;
+  }
+  return h;
+}
+
+struct Case {
+  char op_;
+  int alen_;
+  uint64_t aseed_;
+  bool aneg_;
+  int blen_;
+  uint64_t bseed_;
+  bool bneg_;
+  size_t len_;
+  uint64_t fnv_;
+};
+
+// Generated with Python's int, whose // and % floor like int2048's
+const Case kCases[] = {
+    {'*', 40, 1u, false, 25, 2u, true, 65, 0x722280a9b423a465ull},
+    {'*', 700, 3u, false, 650, 4u, false, 1350, 0x706667e66f6a886eull},
+    {'*', 12000, 5u, true, 80, 6u, false, 12080, 0x6476e3d051c6b474ull},
+    {'*', 12000, 7u, false, 3000, 8u, true, 15001, 0x98a196d877712487ull},
+    {'*', 25000, 9u, false, 24000, 10u, false, 49000, 0x04de16f585f7e190ull},
+    {'/', 1000, 11u, false, 400, 12u, false, 601, 0x13ab4d65e5f8330eull},
+    {'%', 1000, 11u, false, 400, 12u, false, 400, 0x36edad830b4f3864ull},
+    {'/', 12000, 13u, true, 50, 14u, false, 11951, 0x1d6f75d61ba9bd09ull},
+    {'%', 12000, 13u, true, 50, 14u, false, 50, 0xdaf1ba2455d8eb05ull},
+    {'/', 12000, 15u, false, 5000, 16u, true, 7002, 0xd5ecabf41849191bull},
+    {'%', 12000, 15u, false, 5000, 16u, true, 5001, 0x330d9ea5bf05a5ecull},
+    {'/', 30000, 17u, true, 14000, 18u, true, 16000, 0xb8407815ce71de3full},
+    {'%', 30000, 17u, true, 14000, 18u, true, 14001, 0xf5feb357cc45dc34ull},
+    {'+', 5000, 19u, false, 4999, 20u, true, 5000, 0xd0d61374781cf7e8ull},
+    {'-', 5000, 19u, false, 4999, 20u, true, 5000, 0xe24cafee90dc763aull},
+    {'+', 64, 21u, true, 64, 22u, true, 65, 0xa21749c2925d41d5ull},
+    {'-', 64, 21u, true, 64, 22u, true, 64, 0xf78e671d0c5bb091ull},
+};
+
+void RoundTrips() {
+  const int lengths[] = {1, 9, 18, 19, 20, 38, 39, 100, 1000, 5000, 20000};
+  for (int n : lengths) {
+    for (bool negative : {false, true}) {
+      std::string s = Digits(n, n, negative);
+      Check(std::string(sjtu::int2048(s)) == s, "round trip of " + std::to_string(n) + " digits");
+    }
+  }
+  Check(std::string(sjtu::int2048("-0")) == "0", "-0 reads as 0");
+  Check(std::string(sjtu::int2048("000123")) == "123", "leading zeros are dropped");
+}
+
+void Exact() {
+  sjtu::int2048 max64("18446744073709551615");
+  Check(std::string(max64 * max64) == "340282366920938463426481119284349108225", "(2^64-1)^2");
+  sjtu::int2048 two128 = sjtu::int2048("340282366920938463463374607431768211456");
+  Check(std::string(two128 / max64) == "18446744073709551617", "2^128 // (2^64-1)");
+  Check(std::string(two128 % max64) == "1", "2^128 % (2^64-1)");
+  sjtu::int2048 a("-10000000000000000000000000000000000000007"), b("100000000000000000003");
+  Check(std::string(a / b) == "-99999999999999999998", "negative floor division");
+  Check(std::string(a % b) == "99999999999999999987", "negative floor modulo");
+  Check(std::string(sjtu::int2048(999999999999999999LL) * sjtu::int2048(10) + sjtu::int2048(9)) ==
+            "9999999999999999999",
+        "carry across a 64-bit boundary");
+  long long x = 0;
+  Check(sjtu::int2048("-9223372036854775808").to_long_long(x) && x == INT64_MIN, "INT64_MIN fits");
+  Check(!sjtu::int2048("9223372036854775808").to_long_long(x), "2^63 does not fit");
+}
+
+void Vectors() {
+  for (const auto &c : kCases) {
+    sjtu::int2048 a(Digits(c.alen_, c.aseed_, c.aneg_)), b(Digits(c.blen_, c.bseed_, c.bneg_));
+    sjtu::int2048 res;
+    switch (c.op_) {
+      case '+':
+        res = a + b;
+        break;
+      case '-':
+        res = a - b;
+        break;
+      case '*':
+        res = a * b;
+        break;
+      case '/':
+        res = a / b;
+        break;
+      default:
+        res = a % b;
+        break;
+    }
+    std::string s(res);
+    Check(s.size() == c.len_ && Fnv(s) == c.fnv_, std::string(1, c.op_) + " on " + std::to_string(c.alen_) +
+                                                       " and " + std::to_string(c.blen_) + " digits");
+  }
+}
+
+} // namespace
+
+int main() {
+  RoundTrips();
+  Exact();
+  Vectors();
+  if (failures == 0) {
+    std::printf("all passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+# Floored // and % on negative operands, and the LLONG_MIN // -1 edge
+q = 0
+r = 0
+b = 0
+a = -17
+while a < 18:
+    b = -5
+    while b < 6:
+        if b != 0:
+            q = q + a // b
+            r = r + a % b * 3
+        b += 1
+    a += 1
+print(q, r)
+
+fq = 0.0
+fr = 0.0
+c = -7.5
+while c < 8:
+    fq = fq + c / 2.5 * c
+    fr = fr - c * -1.5 * c
+    c += 1.25
+print(fq, fr)
+
+lo = -9223372036854775807 - 1
+u = 0
+v = 0
+d = 1
+w = 0
+while w < 3:
+    u = lo // d
+    v = lo % d
+    d = d - 1
+    if d == 0:
+        d = -1
+    w += 1
+print(u, v, d, w)
+
+m = -9223372036854775807 - 1
+e = m % -1
+g = 0
+while g < 2:
+    e = m // -1
+    g += 1
+print(e, g)
@@ -0,0 +1,38 @@
+# Float compares against a NaN reached partway through the loop
+big = 1e308
+inf = big * 10
+nan = inf - inf
+lt = 0
+le = 0
+gt = 0
+ge = 0
+eq = 0
+ne = 0
+i = 0
+x = 0.0
+while i < 10:
+    if i == 4:
+        x = nan
+    if x < 1.0:
+        lt += 1
+    if x <= 1.0:
+        le += 1
+    if x > -1.0:
+        gt += 1
+    if x >= -1.0:
+        ge += 1
+    if x == x:
+        eq += 1
+    if x != x:
+        ne += 1
+    i += 1
+print(lt, le, gt, ge, eq, ne)
+
+n = 0
+y = 0.0
+while y < 5.0:
+    n += 1
+    y = y + 1.0
+    if n == 3:
+        y = nan
+print(n)
@@ -0,0 +1,36 @@
+# Nested loops leaving and skipping iterations with break and continue
+total = 0
+i = 0
+j = 0
+k = 0
+while i < 30:
+    i += 1
+    if i % 3 == 0:
+        continue
+    j = 0
+    while True:
+        j += 1
+        if j > i:
+            break
+        if j % 2 == 0:
+            continue
+        k = 0
+        while k < j:
+            k += 1
+            if k == 4:
+                break
+            total = total + i * k - j
+    if total > 5000:
+        break
+print(total, i)
+
+p = 0
+count = 0
+while p < 1000:
+    p += 7
+    if p % 5 == 1:
+        continue
+    if p > 500:
+        break
+    count += 1
+print(count, p)
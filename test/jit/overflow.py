@@ -0,0 +1,34 @@
+# Int products and sums that leave int64 partway through a loop, after
+# other variables of the same iteration were already updated
+a = 0
+b = 1
+c = 0
+i = 0
+while i < 60:
+    a += 1
+    c = c + a
+    b = b * 7
+    c = c - i
+    i += 1
+print(a, b, c, i)
+
+x = 9223372036854775800
+n = 0
+while n < 20:
+    x = x + 1
+    n += 1
+print(x, n)
+
+y = -9223372036854775800
+n = 0
+while n < 20:
+    y -= 1
+    n += 1
+print(y, n)
+
+z = 3
+k = 0
+while z < 1000000000000000000000000000000:
+    z = z * z
+    k += 1
+print(z, k)
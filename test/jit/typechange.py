@@ -0,0 +1,46 @@
+# Variables whose type changes while the loop runs
+x = 10
+i = 0
+while i < 20:
+    if i == 5:
+        x = x / 4
+    x = x + 1
+    i += 1
+print(x, i)
+
+s = 0
+t = 1
+j = 0
+while j < 10:
+    s = s + t
+    t = t * 0.5
+    j += 1
+print(s, t)
+
+f = 2.5
+m = 0
+while m < 8:
+    f = f * 2
+    if m == 3:
+        f = 7
+    m += 1
+print(f, m)
+
+# The same inner loop entered with int, then float, then int variables
+acc = 0
+step = 1
+n = 0
+o = 0
+while o < 6:
+    if o == 2:
+        acc = acc + 0.5
+        step = 0.25
+    if o == 4:
+        acc = 3
+        step = 2
+    n = 0
+    while n < 50:
+        acc = acc + step * n
+        n += 1
+    o += 1
+print(acc, step, n, o)
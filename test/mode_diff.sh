@@ -0,0 +1,26 @@
+#!/bin/sh
+# Differential check between interpreter modes: run every program in DIR
+# plainly and then under each FLAGS argument (split on spaces, e.g.
+# "--engine=vm"), and require the same stdout and exit status each time.
+# usage: mode_diff.sh INTERPRETER DIR FLAGS...
+bin=$1
+dir=$2
+shift 2
+tmp=${TMPDIR:-/tmp}/mode_diff.$$
+fail=0
+for f in "$dir"/*.py; do
+  "$bin" < "$f" > "$tmp.ref" 2> /dev/null
+  ref=$?
+  for flags in "$@"; do
+    # $flags is unquoted on purpose: one argument may carry several flags
+    "$bin" $flags < "$f" > "$tmp.out" 2> /dev/null
+    got=$?
+    if [ $ref -ne $got ] || ! cmp -s "$tmp.ref" "$tmp.out"; then
+      echo "FAIL $f $flags (exit $ref plainly, $got with the flags)"
+      diff "$tmp.ref" "$tmp.out" | head -10
+      fail=1
+    fi
+  done
+done
+rm -f "$tmp.ref" "$tmp.out"
+exit $fail